@@ -1,14 +1,23 @@
 ﻿#include "AnimNode_KawaiiPhysics.h"
 
-#include "AnimationRuntime.h"
+#include "KawaiiPhysics.h"
 #include "KawaiiPhysicsBoneConstraintsDataAsset.h"
 #include "KawaiiPhysicsCustomExternalForce.h"
 #include "KawaiiPhysicsExternalForce.h"
 #include "KawaiiPhysicsLimitsDataAsset.h"
+#include "KawaiiPhysicsSharedColliders.h"
+#include "KawaiiPhysicsSimulationCache.h"
+#include "Animation/AnimClassInterface.h"
 #include "Animation/AnimInstanceProxy.h"
 #include "Curves/CurveFloat.h"
+#include "Engine/SkeletalMesh.h"
+#include "GameFramework/Character.h"
+#include "GameFramework/CharacterMovementComponent.h"
 #include "Runtime/Launch/Resources/Version.h"
 #include "SceneInterface.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/UObjectIterator.h"
 
 #if WITH_EDITOR
 #include "UnrealEdGlobals.h"
@@ -30,6 +39,7 @@ DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_Eval"), STAT_KawaiiPhysics_Eval, STATGROU
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_SimulatemodifyBones"), STAT_KawaiiPhysics_SimulatemodifyBones, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_Simulate"), STAT_KawaiiPhysics_Simulate, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_GetWindVelocity"), STAT_KawaiiPhysics_GetWindVelocity, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_SampleWind"), STAT_KawaiiPhysics_SampleWind, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_WorldCollision"), STAT_KawaiiPhysics_WorldCollision, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_AdjustByCollision"), STAT_KawaiiPhysics_AdjustByCollision, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_AdjustByBoneConstraint"), STAT_KawaiiPhysics_AdjustByBoneConstraint,
@@ -39,6 +49,206 @@ DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_UpdatePlanerLimit"), STAT_KawaiiPhysics_U
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_WarmUp"), STAT_KawaiiPhysics_WarmUp, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_UpdatePhysicsSetting"), STAT_KawaiiPhysics_UpdatePhysicsSetting, STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_UpdateCapsuleLimit"), STAT_KawaiiPhysics_UpdateCapsuleLimit, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_GatherPose"), STAT_KawaiiPhysics_GatherPose, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_SelfCollision"), STAT_KawaiiPhysics_SelfCollision, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_SegmentCollision"), STAT_KawaiiPhysics_SegmentCollision, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_SaveState"), STAT_KawaiiPhysics_SaveState, STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_RestoreState"), STAT_KawaiiPhysics_RestoreState, STATGROUP_Anim);
+DECLARE_DWORD_COUNTER_STAT(TEXT("KawaiiPhysics_PoseTransformsFetched"), STAT_KawaiiPhysics_PoseTransformsFetched,
+                           STATGROUP_Anim);
+
+namespace KawaiiPhysics
+{
+	// Offset is in DrivingBone space, so a single composition replaces the bone space round trip
+	bool UpdateLimitTransform(const FTransform& OffsetTransform, int32 PoseGatherSlot,
+	                          const TArray<FTransform>& BoneTransformsCS, FVector3f& OutLocation,
+	                          FQuat4f& OutRotation)
+	{
+		if (!BoneTransformsCS.IsValidIndex(PoseGatherSlot))
+		{
+			return false;
+		}
+
+		const FTransform LimitTransform = OffsetTransform * BoneTransformsCS[PoseGatherSlot];
+		OutLocation = FVector3f(LimitTransform.GetLocation());
+		OutRotation = FQuat4f(LimitTransform.GetRotation());
+		return true;
+	}
+
+	template <typename LimitType>
+	bool UpdateLimitTransform(LimitType& Limit, const TArray<FTransform>& BoneTransformsCS)
+	{
+		return UpdateLimitTransform(Limit.OffsetTransform, Limit.PoseGatherSlot, BoneTransformsCS, Limit.Location,
+		                            Limit.Rotation);
+	}
+
+	// Single precision versions of FMath helpers, which only take FVector
+	FVector3f ClosestPointOnSegment(const FVector3f& Point, const FVector3f& StartPoint, const FVector3f& EndPoint)
+	{
+		const FVector3f Segment = EndPoint - StartPoint;
+		const float SegmentSizeSquared = Segment.SizeSquared();
+		if (SegmentSizeSquared <= UE_SMALL_NUMBER)
+		{
+			return StartPoint;
+		}
+
+		const float T = FVector3f::DotProduct(Point - StartPoint, Segment) / SegmentSizeSquared;
+		return StartPoint + Segment * FMath::Clamp(T, 0.0f, 1.0f);
+	}
+
+	bool SegmentIntersectsPlane(const FVector3f& StartPoint, const FVector3f& EndPoint, const FPlane4f& Plane)
+	{
+		const float StartDist = Plane.PlaneDot(StartPoint);
+		const float EndDist = Plane.PlaneDot(EndPoint);
+		return StartDist != EndDist && StartDist * EndDist <= 0.0f;
+	}
+
+	// Parameters S on P1-Q1 and T on P2-Q2 of the closest points between two segments
+	void ClosestPointsBetweenSegments(const FVector3f& P1, const FVector3f& Q1, const FVector3f& P2,
+	                                  const FVector3f& Q2, float& S, float& T)
+	{
+		const FVector3f D1 = Q1 - P1;
+		const FVector3f D2 = Q2 - P2;
+		const FVector3f R = P1 - P2;
+		const float A = D1.SizeSquared();
+		const float E = D2.SizeSquared();
+		const float F = FVector3f::DotProduct(D2, R);
+
+		S = T = 0.0f;
+		if (A <= UE_SMALL_NUMBER && E <= UE_SMALL_NUMBER)
+		{
+			return;
+		}
+		if (A <= UE_SMALL_NUMBER)
+		{
+			T = FMath::Clamp(F / E, 0.0f, 1.0f);
+			return;
+		}
+
+		const float C = FVector3f::DotProduct(D1, R);
+		if (E <= UE_SMALL_NUMBER)
+		{
+			S = FMath::Clamp(-C / A, 0.0f, 1.0f);
+			return;
+		}
+
+		const float B = FVector3f::DotProduct(D1, D2);
+		const float Denom = A * E - B * B;
+		S = Denom > UE_SMALL_NUMBER ? FMath::Clamp((B * F - C * E) / Denom, 0.0f, 1.0f) : 0.0f;
+		T = (B * S + F) / E;
+		if (T < 0.0f)
+		{
+			T = 0.0f;
+			S = FMath::Clamp(-C / A, 0.0f, 1.0f);
+		}
+		else if (T > 1.0f)
+		{
+			T = 1.0f;
+			S = FMath::Clamp((B - C) / A, 0.0f, 1.0f);
+		}
+	}
+
+	// Push the point at T of the ParentBone-Bone segment out of Point, moving both ends
+	void PushSegmentOutOfPoint(FKawaiiPhysicsModifyBone& ParentBone, FKawaiiPhysicsModifyBone& Bone, float T,
+	                           const FVector3f& Point, float LimitDistance)
+	{
+		const FVector3f ClosestPoint = ParentBone.Location + (Bone.Location - ParentBone.Location) * T;
+		const FVector3f Delta = ClosestPoint - Point;
+		const float DistSquared = Delta.SizeSquared();
+		if (DistSquared >= LimitDistance * LimitDistance || DistSquared <= UE_SMALL_NUMBER)
+		{
+			return;
+		}
+
+		// Weights make the point at T move by exactly Correction. A non simulated end does not move
+		const float ParentWeight = ParentBone.bSkipSimulate ? 0.0f : 1.0f - T;
+		const float BoneWeight = T;
+		const float WeightSquaredSum = ParentWeight * ParentWeight + BoneWeight * BoneWeight;
+		// Close to a fixed end the other end would be thrown far away : the point collision of the end handles it
+		if (WeightSquaredSum < 0.01f)
+		{
+			return;
+		}
+
+		const float Dist = FMath::Sqrt(DistSquared);
+		const FVector3f Correction = Delta * ((LimitDistance - Dist) / (Dist * WeightSquaredSum));
+		ParentBone.Location += Correction * ParentWeight;
+		Bone.Location += Correction * BoneWeight;
+	}
+
+	// One collider against one bone or segment, shared by the node's own limits and the LimitsDataAsset ones
+	void AdjustBySphere(FKawaiiPhysicsModifyBone& Bone, const FVector3f& Center, float Radius,
+	                    ESphericalLimitType LimitType)
+	{
+		const float LimitDistance = Bone.PhysicsSettings.Radius + Radius;
+		if (LimitType == ESphericalLimitType::Outer)
+		{
+			if ((Bone.Location - Center).SizeSquared() > LimitDistance * LimitDistance)
+			{
+				return;
+			}
+			Bone.Location += (LimitDistance - (Bone.Location - Center).Size()) * (Bone.Location - Center).
+				GetSafeNormal();
+		}
+		else
+		{
+			if ((Bone.Location - Center).SizeSquared() < LimitDistance * LimitDistance)
+			{
+				return;
+			}
+			Bone.Location = Center + (Radius - Bone.PhysicsSettings.Radius) * (Bone.Location - Center).GetSafeNormal();
+		}
+	}
+
+	void AdjustByCapsule(FKawaiiPhysicsModifyBone& Bone, const FVector3f& StartPoint, const FVector3f& EndPoint,
+	                     float Radius)
+	{
+		const FVector3f ClosestPoint = ClosestPointOnSegment(Bone.Location, StartPoint, EndPoint);
+		const float DistSquared = (Bone.Location - ClosestPoint).SizeSquared();
+
+		const float LimitDistance = Bone.PhysicsSettings.Radius + Radius;
+		if (DistSquared < LimitDistance * LimitDistance)
+		{
+			Bone.Location = ClosestPoint + (Bone.Location - ClosestPoint).GetSafeNormal() * LimitDistance;
+		}
+	}
+
+	void AdjustByPlane(FKawaiiPhysicsModifyBone& Bone, const FPlane4f& Plane)
+	{
+		const FVector3f PointOnPlane = FVector3f::PointPlaneProject(Bone.Location, Plane);
+		const float DistSquared = (Bone.Location - PointOnPlane).SizeSquared();
+
+		if (DistSquared < Bone.PhysicsSettings.Radius * Bone.PhysicsSettings.Radius ||
+			SegmentIntersectsPlane(Bone.Location, Bone.PrevLocation, Plane))
+		{
+			Bone.Location = PointOnPlane + Plane.GetNormal() * Bone.PhysicsSettings.Radius;
+		}
+	}
+
+	void AdjustSegmentBySphere(FKawaiiPhysicsModifyBone& Bone, FKawaiiPhysicsModifyBone& ParentBone,
+	                           const FVector3f& Center, float Radius)
+	{
+		const FVector3f Segment = Bone.Location - ParentBone.Location;
+		const float SegmentSizeSquared = Segment.SizeSquared();
+		if (SegmentSizeSquared <= UE_SMALL_NUMBER)
+		{
+			return;
+		}
+
+		const float T = FMath::Clamp(FVector3f::DotProduct(Center - ParentBone.Location, Segment) / SegmentSizeSquared,
+		                             0.0f, 1.0f);
+		PushSegmentOutOfPoint(ParentBone, Bone, T, Center, Bone.PhysicsSettings.Radius + Radius);
+	}
+
+	void AdjustSegmentByCapsule(FKawaiiPhysicsModifyBone& Bone, FKawaiiPhysicsModifyBone& ParentBone,
+	                            const FVector3f& StartPoint, const FVector3f& EndPoint, float Radius)
+	{
+		float S, T;
+		ClosestPointsBetweenSegments(ParentBone.Location, Bone.Location, StartPoint, EndPoint, S, T);
+		const FVector3f PointOnCapsule = StartPoint + (EndPoint - StartPoint) * T;
+		PushSegmentOutOfPoint(ParentBone, Bone, S, PointOnCapsule, Bone.PhysicsSettings.Radius + Radius);
+	}
+}
 
 FAnimNode_KawaiiPhysics::FAnimNode_KawaiiPhysics()
 	: DeltaTime(0)
@@ -49,10 +259,12 @@ FAnimNode_KawaiiPhysics::FAnimNode_KawaiiPhysics()
 
 void FAnimNode_KawaiiPhysics::Initialize_AnyThread(const FAnimationInitializeContext& Context)
 {
+	LLM_SCOPE_BYTAG(KawaiiPhysics);
+
 	FAnimNode_SkeletalControlBase::Initialize_AnyThread(Context);
 	const FBoneContainer& RequiredBones = Context.AnimInstanceProxy->GetRequiredBones();
 
-	ApplyLimitsDataAsset(RequiredBones);
+	ApplyLimitsDataAsset();
 	ApplyBoneConstraintDataAsset(RequiredBones);
 
 	ModifyBones.Empty();
@@ -62,6 +274,19 @@ void FAnimNode_KawaiiPhysics::Initialize_AnyThread(const FAnimationInitializeCon
 
 	bResetDynamics = false;
 
+	int32 Seed = RandomSeed;
+	if (bDeriveRandomSeedFromOwner)
+	{
+		if (const USkeletalMeshComponent* SkelComp = Context.AnimInstanceProxy->GetSkelMeshComponent())
+		{
+			if (const AActor* Owner = SkelComp->GetOwner())
+			{
+				Seed = static_cast<int32>(HashCombine(GetTypeHash(Seed), GetTypeHash(Owner->GetFName())));
+			}
+		}
+	}
+	RandomStream.Initialize(Seed);
+
 	for (int i = 0; i < ExternalForces.Num(); ++i)
 	{
 		if (ExternalForces[i].IsValid())
@@ -87,6 +312,11 @@ void FAnimNode_KawaiiPhysics::UpdateInternal(const FAnimationUpdateContext& Cont
 	FAnimNode_SkeletalControlBase::UpdateInternal(Context);
 
 	DeltaTime = Context.GetDeltaTime();
+
+	if (SimulationCacheMode != EKawaiiPhysicsSimulationCacheMode::None && bAdvanceSimulationCacheTime)
+	{
+		SimulationCacheTime += DeltaTime;
+	}
 }
 
 void FAnimNode_KawaiiPhysics::GatherDebugData(FNodeDebugData& DebugData)
@@ -100,9 +330,11 @@ void FAnimNode_KawaiiPhysics::GatherDebugData(FNodeDebugData& DebugData)
 #if ENABLE_ANIM_DEBUG
 void FAnimNode_KawaiiPhysics::AnimDrawDebug(const FComponentSpacePoseContext& Output)
 {
-	if (const UWorld* World = Output.AnimInstanceProxy->GetSkelMeshComponent()->GetWorld(); !World->IsPreviewWorld())
+	// SkelComp/World can be null when evaluated without a registered component (e.g. automation tests)
+	const USkeletalMeshComponent* SkelComp = Output.AnimInstanceProxy->GetSkelMeshComponent();
+	if (const UWorld* World = SkelComp ? SkelComp->GetWorld() : nullptr; World && !World->IsPreviewWorld())
 	{
-		if (Output.AnimInstanceProxy->GetSkelMeshComponent()->bRecentlyRendered)
+		if (SkelComp->bRecentlyRendered)
 		{
 			if (CVarAnimNodeKawaiiPhysicsDebug.GetValueOnAnyThread())
 			{
@@ -112,7 +344,7 @@ void FAnimNode_KawaiiPhysics::AnimDrawDebug(const FComponentSpacePoseContext& Ou
 				for (const auto& ModifyBone : ModifyBones)
 				{
 					const FVector LocationWS = AnimInstanceProxy->GetComponentTransform().TransformPosition(
-						ModifyBone.Location);
+						FVector(ModifyBone.Location));
 					auto Color = ModifyBone.bDummy ? FColor::Red : FColor::Yellow;
 					AnimInstanceProxy->AnimDrawDebugSphere(LocationWS, ModifyBone.PhysicsSettings.Radius, 8,
 					                                       Color, false, -1, 0, SDPG_Foreground);
@@ -124,7 +356,7 @@ void FAnimNode_KawaiiPhysics::AnimDrawDebug(const FComponentSpacePoseContext& Ou
 					{
 						AnimInstanceProxy->AnimDrawDebugInWorldMessage(
 							FString::Printf(TEXT("%.2f"), ModifyBone.LengthFromRoot / GetTotalBoneLength()),
-							ModifyBone.Location, FColor::White, 1.0f);
+							FVector(ModifyBone.Location), FColor::White, 1.0f);
 					}
 #endif
 				}
@@ -132,15 +364,26 @@ void FAnimNode_KawaiiPhysics::AnimDrawDebug(const FComponentSpacePoseContext& Ou
 				for (const auto& SphericalLimit : SphericalLimits)
 				{
 					const FVector LocationWS = AnimInstanceProxy->GetComponentTransform().TransformPosition(
-						SphericalLimit.Location);
+						FVector(SphericalLimit.Location));
 					AnimInstanceProxy->AnimDrawDebugSphere(LocationWS, SphericalLimit.Radius, 8, FColor::Orange,
 					                                       false, -1, 0, SDPG_Foreground);
 				}
-				for (const auto& SphericalLimit : SphericalLimitsData)
+				{
+					const TConstArrayView<FSphericalLimit> Definitions = GetSphericalLimitsDataDefinitions();
+					const TConstArrayView<FKawaiiPhysicsLimitInstance> Instances = GetSphericalLimitsDataInstances();
+					for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
+					{
+						const FVector LocationWS = AnimInstanceProxy->GetComponentTransform().TransformPosition(
+							FVector(Instances[i].Location));
+						AnimInstanceProxy->AnimDrawDebugSphere(LocationWS, Definitions[i].Radius, 8, FColor::Blue,
+						                                       false, -1, 0, SDPG_Foreground);
+					}
+				}
+				for (const auto& SphericalLimit : SphericalLimitsPhysicsAsset)
 				{
 					const FVector LocationWS = AnimInstanceProxy->GetComponentTransform().TransformPosition(
-						SphericalLimit.Location);
-					AnimInstanceProxy->AnimDrawDebugSphere(LocationWS, SphericalLimit.Radius, 8, FColor::Blue,
+						FVector(SphericalLimit.Location));
+					AnimInstanceProxy->AnimDrawDebugSphere(LocationWS, SphericalLimit.Radius, 8, FColor::Cyan,
 					                                       false, -1, 0, SDPG_Foreground);
 				}
 
@@ -149,24 +392,39 @@ void FAnimNode_KawaiiPhysics::AnimDrawDebug(const FComponentSpacePoseContext& Ou
 				for (const auto& CapsuleLimit : CapsuleLimits)
 				{
 					const FVector LocationWS = AnimInstanceProxy->GetComponentTransform().TransformPosition(
-						CapsuleLimit.Location);
+						FVector(CapsuleLimit.Location));
 					const FQuat RotationWS = AnimInstanceProxy->GetComponentTransform().TransformRotation(
-						CapsuleLimit.Rotation);
+						FQuat(CapsuleLimit.Rotation));
 
 					AnimInstanceProxy->AnimDrawDebugCapsule(LocationWS, CapsuleLimit.Length * 0.5f,
 					                                        CapsuleLimit.Radius, RotationWS.Rotator(),
 					                                        FColor::Orange);
 				}
-				for (const auto& CapsuleLimit : CapsuleLimitsData)
+				{
+					const TConstArrayView<FCapsuleLimit> Definitions = GetCapsuleLimitsDataDefinitions();
+					const TConstArrayView<FKawaiiPhysicsLimitInstance> Instances = GetCapsuleLimitsDataInstances();
+					for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
+					{
+						const FVector LocationWS = AnimInstanceProxy->GetComponentTransform().TransformPosition(
+							FVector(Instances[i].Location));
+						const FQuat RotationWS = AnimInstanceProxy->GetComponentTransform().TransformRotation(
+							FQuat(Instances[i].Rotation));
+
+						AnimInstanceProxy->AnimDrawDebugCapsule(LocationWS, Definitions[i].Length * 0.5f,
+						                                        Definitions[i].Radius, RotationWS.Rotator(),
+						                                        FColor::Blue);
+					}
+				}
+				for (const auto& CapsuleLimit : CapsuleLimitsPhysicsAsset)
 				{
 					const FVector LocationWS = AnimInstanceProxy->GetComponentTransform().TransformPosition(
-						CapsuleLimit.Location);
+						FVector(CapsuleLimit.Location));
 					const FQuat RotationWS = AnimInstanceProxy->GetComponentTransform().TransformRotation(
-						CapsuleLimit.Rotation);
+						FQuat(CapsuleLimit.Rotation));
 
 					AnimInstanceProxy->AnimDrawDebugCapsule(LocationWS, CapsuleLimit.Length * 0.5f,
 					                                        CapsuleLimit.Radius, RotationWS.Rotator(),
-					                                        FColor::Blue);
+					                                        FColor::Cyan);
 				}
 #endif
 			}
@@ -179,6 +437,7 @@ void FAnimNode_KawaiiPhysics::EvaluateSkeletalControl_AnyThread(FComponentSpaceP
                                                                 TArray<FBoneTransform>& OutBoneTransforms)
 {
 	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_Eval);
+	LLM_SCOPE_BYTAG(KawaiiPhysics);
 
 	check(OutBoneTransforms.Num() == 0);
 
@@ -187,6 +446,7 @@ void FAnimNode_KawaiiPhysics::EvaluateSkeletalControl_AnyThread(FComponentSpaceP
 		ModifyBones.Empty(ModifyBones.Num());
 		bResetDynamics = false;
 		bInitPhysicsSettings = false;
+		RandomStream.Reset();
 	}
 
 	const FBoneContainer& BoneContainer = Output.Pose.GetPose().GetBoneContainer();
@@ -196,7 +456,7 @@ void FAnimNode_KawaiiPhysics::EvaluateSkeletalControl_AnyThread(FComponentSpaceP
 	// sync editing on other Nodes
 	if (LimitsDataAsset)
 	{
-		ApplyLimitsDataAsset(BoneContainer);
+		ApplyLimitsDataAsset();
 	}
 	if (BoneConstraintsDataAsset)
 	{
@@ -219,7 +479,8 @@ void FAnimNode_KawaiiPhysics::EvaluateSkeletalControl_AnyThread(FComponentSpaceP
 	if (ModifyBones.Num() == 0)
 	{
 		InitModifyBones(Output, BoneContainer);
-		InitBoneConstraints();
+		InitBoneConstraints(BoneContainer);
+		InitExternalForces();
 		PreSkelCompTransform = ComponentTransform;
 	}
 
@@ -235,26 +496,61 @@ void FAnimNode_KawaiiPhysics::EvaluateSkeletalControl_AnyThread(FComponentSpaceP
 			bInitPhysicsSettings = true;
 		}
 	}
-	UpdateSphericalLimits(SphericalLimits, Output, BoneContainer, ComponentTransform);
-	UpdateSphericalLimits(SphericalLimitsData, Output, BoneContainer, ComponentTransform);
-	UpdateCapsuleLimits(CapsuleLimits, Output, BoneContainer, ComponentTransform);
-	UpdateCapsuleLimits(CapsuleLimitsData, Output, BoneContainer, ComponentTransform);
-	UpdatePlanerLimits(PlanarLimits, Output, BoneContainer, ComponentTransform);
-	UpdatePlanerLimits(PlanarLimitsData, Output, BoneContainer, ComponentTransform);
+
+	UpdateSharedColliders(Output);
+
+	// Fetch every component space transform needed by bones, limits and forces once
+	GatherPoseTransforms(Output, BoneContainer);
+
+	UpdateSphericalLimits(SphericalLimits, BoneTransformsCS);
+	UpdateSphericalLimits(GetSphericalLimitsDataDefinitions(), SphericalLimitsDataInstances, BoneTransformsCS);
+	UpdateCapsuleLimits(CapsuleLimits, BoneTransformsCS);
+	UpdateCapsuleLimits(GetCapsuleLimitsDataDefinitions(), CapsuleLimitsDataInstances, BoneTransformsCS);
+	UpdatePlanerLimits(PlanarLimits, BoneTransformsCS);
+	UpdatePlanerLimits(GetPlanarLimitsDataDefinitions(), PlanarLimitsDataInstances, BoneTransformsCS);
+	UpdateSphericalLimits(SphericalLimitsPhysicsAsset, BoneTransformsCS);
+	UpdateCapsuleLimits(CapsuleLimitsPhysicsAsset, BoneTransformsCS);
 
 	// Update Bone Pose Transform
-	UpdateModifyBonesPoseTransform(Output, BoneContainer);
+	UpdateModifyBonesPoseTransform();
 
 	// Update SkeletalMeshComponent movement in World Space
+	const FTransform LastSkelCompTransform = PreSkelCompTransform;
 	UpdateSkelCompMove(ComponentTransform);
 
 	// Simulate Physics and Apply
-	if (bNeedWarmUp && WarmUpFrames > 0)
+	if (!PlaybackSimulationCache())
 	{
-		WarmUp(Output, BoneContainer, ComponentTransform);
-		bNeedWarmUp = false;
+		const bool bRecordCache = SimulationCacheMode == EKawaiiPhysicsSimulationCacheMode::Record && SimulationCache;
+		int32 FirstCacheFrame = INDEX_NONE;
+		if (bRecordCache)
+		{
+			FirstCacheFrame = BeginSimulationCacheFrame();
+		}
+
+		if (bNeedWarmUp && WarmUpFrames > 0)
+		{
+			WarmUp(Output, BoneContainer, ComponentTransform);
+			bNeedWarmUp = false;
+		}
+
+		if (bRecordCache)
+		{
+			if (FirstCacheFrame != INDEX_NONE)
+			{
+				RecordSimulationCacheFrames(Output, ComponentTransform, FirstCacheFrame);
+			}
+			else
+			{
+				// Still on the last recorded frame : hold it, and carry the component movement to the next step
+				PreSkelCompTransform = LastSkelCompTransform;
+			}
+		}
+		else
+		{
+			SimulateModifyBones(Output, ComponentTransform);
+		}
 	}
-	SimulateModifyBones(Output, ComponentTransform);
 	ApplySimulateResult(Output, BoneContainer, OutBoneTransforms);
 
 #if ENABLE_ANIM_DEBUG
@@ -276,19 +572,104 @@ bool FAnimNode_KawaiiPhysics::IsValidToEvaluate(const USkeleton* Skeleton, const
 	return RootBone.BoneName.IsValid();
 }
 
-bool FAnimNode_KawaiiPhysics::HasPreUpdate() const
+void FAnimNode_KawaiiPhysics::UpdatePhysicsAssetLimits(const USkeletalMeshComponent* SkelComp)
 {
-#if WITH_EDITOR
-	return true;
+	const UPhysicsAsset* PhysicsAsset = bUsePhysicsAssetAsLimits && SkelComp ? SkelComp->GetPhysicsAsset() : nullptr;
+#if	ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
+	const USkeletalMesh* SkeletalMesh = SkelComp ? SkelComp->GetSkeletalMeshAsset() : nullptr;
 #else
-	return false;
+	const USkeletalMesh* SkeletalMesh = SkelComp ? SkelComp->SkeletalMesh : nullptr;
 #endif
+
+	// The bodies are filtered by the chain and the ignore lists, which can change at runtime and while editing
+	uint32 FilterHash = HashCombine(GetTypeHash(SkeletalMesh), GetTypeHash(RootBone.BoneName));
+	for (const auto& BoneRef : IgnoreBones)
+	{
+		FilterHash = HashCombine(FilterHash, GetTypeHash(BoneRef.BoneName));
+	}
+	for (const auto& BoneNamePrefix : IgnoreBoneNamePrefix)
+	{
+		FilterHash = HashCombine(FilterHash, GetTypeHash(BoneNamePrefix));
+	}
+
+	if (PhysicsAsset == LimitsPhysicsAsset.Get() && FilterHash == LimitsPhysicsAssetFilterHash &&
+		(PhysicsAsset || SphericalLimitsPhysicsAsset.Num() + CapsuleLimitsPhysicsAsset.Num() == 0))
+	{
+		return;
+	}
+
+	LimitsPhysicsAsset = PhysicsAsset;
+	LimitsPhysicsAssetFilterHash = FilterHash;
+	SphericalLimitsPhysicsAsset.Reset();
+	CapsuleLimitsPhysicsAsset.Reset();
+	bPoseGatherDirty = true;
+	const TSharedPtr<const FKawaiiPhysicsPhysicsAssetLimits> Limits =
+		FKawaiiPhysicsPhysicsAssetLimits::FindOrAdd(PhysicsAsset);
+	if (!Limits || !SkeletalMesh)
+	{
+		return;
+	}
+
+	// Same rules as the self collision of WorldCollision
+	const FReferenceSkeleton& RefSkeleton = SkeletalMesh->GetRefSkeleton();
+	const int32 RootBoneIndex = RefSkeleton.FindBoneIndex(RootBone.BoneName);
+	auto IsIgnored = [&](const FName& BoneName)
+	{
+		// Bodies on the chain itself would follow the simulation
+		const int32 BoneIndex = RefSkeleton.FindBoneIndex(BoneName);
+		if (BoneIndex == INDEX_NONE || (RootBoneIndex != INDEX_NONE &&
+			(BoneIndex == RootBoneIndex || RefSkeleton.BoneIsChildOf(BoneIndex, RootBoneIndex))))
+		{
+			return true;
+		}
+		for (const auto& BoneRef : IgnoreBones)
+		{
+			if (BoneRef.BoneName == BoneName)
+			{
+				return true;
+			}
+		}
+		const FString BoneNameString = BoneName.ToString();
+		for (const auto& BoneNamePrefix : IgnoreBoneNamePrefix)
+		{
+			if (BoneNameString.StartsWith(BoneNamePrefix.ToString()))
+			{
+				return true;
+			}
+		}
+		return false;
+	};
+
+	for (const auto& Sphere : Limits->SphericalLimits)
+	{
+		if (!IsIgnored(Sphere.DrivingBone.BoneName))
+		{
+			SphericalLimitsPhysicsAsset.Add(Sphere);
+		}
+	}
+	for (const auto& Capsule : Limits->CapsuleLimits)
+	{
+		if (!IsIgnored(Capsule.DrivingBone.BoneName))
+		{
+			CapsuleLimitsPhysicsAsset.Add(Capsule);
+		}
+	}
+}
+
+bool FAnimNode_KawaiiPhysics::HasPreUpdate() const
+{
+	// Everything read from the component, owner and world is captured on the game thread
+	return true;
 }
 
 void FAnimNode_KawaiiPhysics::PreUpdate(const UAnimInstance* InAnimInstance)
 {
+	LLM_SCOPE_BYTAG(KawaiiPhysics);
+
+	const UWorld* World = InAnimInstance->GetWorld();
+
 #if WITH_EDITOR
-	if (const UWorld* World = InAnimInstance->GetWorld())
+	if (World)
 	{
 		if (World->WorldType == EWorldType::Editor ||
 			World->WorldType == EWorldType::EditorPreview)
@@ -297,6 +678,102 @@ void FAnimNode_KawaiiPhysics::PreUpdate(const UAnimInstance* InAnimInstance)
 		}
 	}
 #endif
+
+	const USkeletalMeshComponent* SkelComp = InAnimInstance->GetSkelMeshComponent();
+
+	UpdateGameThreadInput(SkelComp);
+	UpdatePhysicsAssetLimits(SkelComp);
+
+	// Quantizing marks the asset dirty : done here once the recording is switched off
+	if (SimulationCache && SimulationCache->IsRecording() &&
+		SimulationCacheMode != EKawaiiPhysicsSimulationCacheMode::Record)
+	{
+		SimulationCache->FinishRecording();
+		LastRecordedCacheFrame = INDEX_NONE;
+	}
+
+	GameThreadInput.bWindSampled = false;
+	if (bEnableWind && World && World->Scene && SkelComp)
+	{
+		SampleWind(World->Scene, SkelComp->GetComponentTransform());
+	}
+
+	PreApplyExternalForces(SkelComp);
+}
+
+void FAnimNode_KawaiiPhysics::PreApplyExternalForces(const USkeletalMeshComponent* SkelComp)
+{
+	// External Force : parameters are computed here, not on the worker thread
+	for (int i = 0; i < ExternalForces.Num(); ++i)
+	{
+		if (ExternalForces[i].IsValid())
+		{
+			ExternalForces[i].GetMutable<FKawaiiPhysics_ExternalForce>().PreApply(*this, SkelComp);
+		}
+	}
+
+	// Custom External Force : Blueprint parameters are computed here, not on the worker thread
+	// NOTE: if use foreach, you may get issue ( Array has changed during ranged-for iteration )
+	for (int i = 0; i < CustomExternalForces.Num(); ++i)
+	{
+		if (CustomExternalForces[i] && CustomExternalForces[i]->bIsEnabled)
+		{
+			CustomExternalForces[i]->PreUpdate(*this, SkelComp);
+		}
+	}
+}
+
+void FAnimNode_KawaiiPhysics::UpdateGameThreadInput(const USkeletalMeshComponent* SkelComp)
+{
+	FKawaiiPhysicsGameThreadInput& Input = GameThreadInput;
+	Input.bValid = SkelComp != nullptr;
+	Input.bHasCharacter = false;
+	Input.bHasCharacterMovement = false;
+	Input.World = nullptr;
+	Input.OwningComp = nullptr;
+	if (!SkelComp)
+	{
+		return;
+	}
+
+	Input.ComponentTransform = SkelComp->GetComponentTransform();
+
+	// For Character's Custom Gravity Direction
+	if (const ACharacter* Character = Cast<ACharacter>(SkelComp->GetOwner()))
+	{
+		Input.bHasCharacter = true;
+#if	ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3
+		Input.CharacterGravityDirection = Character->GetGravityDirection();
+#endif
+		if (const UCharacterMovementComponent* CharacterMovementComponent = Character->GetCharacterMovement())
+		{
+			Input.bHasCharacterMovement = true;
+			Input.CharacterGravityZ = CharacterMovementComponent->GetGravityZ();
+		}
+	}
+
+	// Captured even when bAllowWorldCollision is off : it can be driven by a pin after PreUpdate
+	Input.World = SkelComp->GetWorld();
+	Input.OwningComp = SkelComp;
+	Input.CollisionChannel = bOverrideCollisionParams
+		                         ? CollisionChannelSettings.GetObjectType()
+		                         : SkelComp->GetCollisionObjectType();
+	Input.CollisionResponseParams = bOverrideCollisionParams
+		                                ? FCollisionResponseParams(CollisionChannelSettings.GetResponseToChannels())
+		                                : FCollisionResponseParams(SkelComp->GetCollisionResponseToChannels());
+
+	// Rebuilt only when the component or bIgnoreSelfComponent changes, not every frame
+	if (Input.CollisionQueryComp.Get() != SkelComp || Input.bCollisionQueryIgnoresComp != bIgnoreSelfComponent)
+	{
+		/** the trace is not done in game thread, so TraceTag does not draw debug traces*/
+		Input.CollisionQueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(KawaiiCollision));
+		if (bIgnoreSelfComponent)
+		{
+			Input.CollisionQueryParams.AddIgnoredComponent(SkelComp);
+		}
+		Input.CollisionQueryComp = SkelComp;
+		Input.bCollisionQueryIgnoresComp = bIgnoreSelfComponent;
+	}
 }
 
 void FAnimNode_KawaiiPhysics::InitializeBoneReferences(const FBoneContainer& RequiredBones)
@@ -312,9 +789,10 @@ void FAnimNode_KawaiiPhysics::InitializeBoneReferences(const FBoneContainer& Req
 
 
 	RootBone.Initialize(RequiredBones);
-	for (auto& Bone : ModifyBones)
+	bPoseGatherDirty = true;
+	for (auto& BoneRef : ModifyBoneRefs)
 	{
-		Bone.BoneRef.Initialize(RequiredBones);
+		BoneRef.Initialize(RequiredBones);
 	}
 
 	Initialize(SphericalLimits);
@@ -335,53 +813,67 @@ void FAnimNode_KawaiiPhysics::InitModifyBones(FComponentSpacePoseContext& Output
 	auto& RefSkeleton = Skeleton->GetReferenceSkeleton();
 
 	ModifyBones.Empty();
+	ModifyBoneRefs.Empty();
+	BoneTransformsCS.Reset();
+	OutputBoneSlots.Reset();
+	bPoseGatherDirty = true;
 	AddModifyBone(Output, BoneContainer, RefSkeleton, RefSkeleton.FindBoneIndex(RootBone.BoneName));
+	ModifyBones.Shrink();
+	ModifyBoneRefs.Shrink();
+	InitChildIndices();
 	if (ModifyBones.Num() > 0)
 	{
 		TotalBoneLength = 0.0f;
 
 		CalcBoneLength(ModifyBones[0], BoneContainer.GetRefPoseArray());
 	}
+
+	// Each child of the root bone starts a chain. Parents are always before their children
+	SelfCollisionChains.Init(INDEX_NONE, ModifyBones.Num());
+	for (int32 i = 1; i < ModifyBones.Num(); ++i)
+	{
+		const int32 ParentIndex = ModifyBones[i].ParentIndex;
+		SelfCollisionChains[i] = ParentIndex == 0 ? i : SelfCollisionChains[ParentIndex];
+	}
 }
 
-void FAnimNode_KawaiiPhysics::ApplyLimitsDataAsset(const FBoneContainer& RequiredBones)
+void FAnimNode_KawaiiPhysics::ApplyLimitsDataAsset()
 {
-	auto Initialize = [&RequiredBones](auto& Targets)
+	// Shared colliders keep their state in FKawaiiPhysicsColliderSet instead
+	const UKawaiiPhysicsLimitsDataAsset* DataAsset = SharedColliders ? nullptr : LimitsDataAsset.Get();
+
+	// The limits are read from the asset : only the state is resized, when the asset or its limits changed
+	const uint32 Revision = DataAsset ? DataAsset->GetRevision() : 0;
+	if (Revision != AppliedLimitsDataAssetRevision)
 	{
-		for (auto& Target : Targets)
+		SphericalLimitsDataInstances.Reset();
+		CapsuleLimitsDataInstances.Reset();
+		PlanarLimitsDataInstances.Reset();
+		if (DataAsset)
 		{
-			Target.DrivingBone.Initialize(RequiredBones);
+			SphericalLimitsDataInstances.SetNum(DataAsset->SphericalLimits.Num());
+			CapsuleLimitsDataInstances.SetNum(DataAsset->CapsuleLimits.Num());
+			PlanarLimitsDataInstances.SetNum(DataAsset->PlanarLimits.Num());
 		}
-		return true;
-	};
-
-	SphericalLimitsData.Empty();
-	CapsuleLimitsData.Empty();
-	PlanarLimitsData.Empty();
-
-	if (LimitsDataAsset)
-	{
-		SphericalLimitsData = LimitsDataAsset->SphericalLimits;
-		CapsuleLimitsData = LimitsDataAsset->CapsuleLimits;
-		PlanarLimitsData = LimitsDataAsset->PlanarLimits;
+		AppliedLimitsDataAssetRevision = Revision;
+		bPoseGatherDirty = true;
 	}
-
-	Initialize(SphericalLimitsData);
-	Initialize(CapsuleLimitsData);
-	Initialize(PlanarLimitsData);
 }
 
 void FAnimNode_KawaiiPhysics::ApplyBoneConstraintDataAsset(const FBoneContainer& RequiredBones)
 {
-	BoneConstraintsData.Empty();
+	// Preview only : InitBoneConstraints reads the constraints from the asset
+#if WITH_EDITOR
+	BoneConstraintsData.Reset();
 	if (BoneConstraintsDataAsset)
 	{
-		BoneConstraintsData = BoneConstraintsDataAsset->GenerateBoneConstraints();
+		BoneConstraintsDataAsset->AppendBoneConstraints(BoneConstraintsData);
 		for (auto& BoneConstraint : BoneConstraintsData)
 		{
 			BoneConstraint.InitializeBone(RequiredBones);
 		}
 	}
+#endif
 }
 
 int32 FAnimNode_KawaiiPhysics::AddModifyBone(FComponentSpacePoseContext& Output, const FBoneContainer& BoneContainer,
@@ -400,24 +892,23 @@ int32 FAnimNode_KawaiiPhysics::AddModifyBone(FComponentSpacePoseContext& Output,
 		return INDEX_NONE;
 	}
 
-	FKawaiiPhysicsModifyBone NewModifyBone;
-	NewModifyBone.BoneRef = BoneRef;
-	NewModifyBone.BoneRef.Initialize(BoneContainer);
-	if (NewModifyBone.BoneRef.CachedCompactPoseIndex == INDEX_NONE)
+	BoneRef.Initialize(BoneContainer);
+	if (BoneRef.CachedCompactPoseIndex == INDEX_NONE)
 	{
 		return INDEX_NONE;
 	}
 
-	auto& RefBonePoseTransform = Output.Pose.GetComponentSpaceTransform(NewModifyBone.BoneRef.CachedCompactPoseIndex);
-	NewModifyBone.Location = RefBonePoseTransform.GetLocation();
+	// BoneTransformsCS starts with the current pose, kept by bones missing from a later LOD
+	const FTransform& RefBonePoseTransform = Output.Pose.GetComponentSpaceTransform(BoneRef.CachedCompactPoseIndex);
+	FKawaiiPhysicsModifyBone NewModifyBone;
+	NewModifyBone.Location = FVector3f(RefBonePoseTransform.GetLocation());
 	NewModifyBone.PrevLocation = NewModifyBone.Location;
-	NewModifyBone.PoseLocation = NewModifyBone.Location;
-	NewModifyBone.PrevRotation = RefBonePoseTransform.GetRotation();
-	NewModifyBone.PoseRotation = NewModifyBone.PrevRotation;
-	NewModifyBone.PoseScale = RefBonePoseTransform.GetScale3D();
+	NewModifyBone.PrevRotation = FQuat4f(RefBonePoseTransform.GetRotation());
 
 	int32 ModifyBoneIndex = ModifyBones.Add(NewModifyBone);
 	ModifyBones[ModifyBoneIndex].Index = ModifyBoneIndex;
+	ModifyBoneRefs.Add(BoneRef);
+	BoneTransformsCS.Add(RefBonePoseTransform);
 
 	TArray<int32> ChildBoneIndexs;
 	CollectChildBones(RefSkeleton, BoneIndex, ChildBoneIndexs);
@@ -430,7 +921,6 @@ int32 FAnimNode_KawaiiPhysics::AddModifyBone(FComponentSpacePoseContext& Output,
 			auto ChildModifyBoneIndex = AddModifyBone(Output, BoneContainer, RefSkeleton, ChildBoneIndex);
 			if (ChildModifyBoneIndex >= 0)
 			{
-				ModifyBones[ModifyBoneIndex].ChildIndexs.Add(ChildModifyBoneIndex);
 				ModifyBones[ChildModifyBoneIndex].ParentIndex = ModifyBoneIndex;
 				AddedChildBone = true;
 			}
@@ -445,21 +935,54 @@ int32 FAnimNode_KawaiiPhysics::AddModifyBone(FComponentSpacePoseContext& Output,
 		DummyModifyBone.Location = NewModifyBone.Location + GetBoneForwardVector(NewModifyBone.PrevRotation) *
 			DummyBoneLength;
 		DummyModifyBone.PrevLocation = DummyModifyBone.Location;
-		DummyModifyBone.PoseLocation = DummyModifyBone.Location;
 		DummyModifyBone.PrevRotation = NewModifyBone.PrevRotation;
-		DummyModifyBone.PoseRotation = DummyModifyBone.PrevRotation;
-		DummyModifyBone.PoseScale = RefBonePoseTransform.GetScale3D();
 
 		int32 DummyBoneIndex = ModifyBones.Add(DummyModifyBone);
-		ModifyBones[ModifyBoneIndex].ChildIndexs.Add(DummyBoneIndex);
 		ModifyBones[DummyBoneIndex].Index = DummyBoneIndex;
 		ModifyBones[DummyBoneIndex].ParentIndex = ModifyBoneIndex;
+		ModifyBoneRefs.AddDefaulted();
+		BoneTransformsCS.Emplace(RefBonePoseTransform.GetRotation(), FVector(DummyModifyBone.Location),
+		                         RefBonePoseTransform.GetScale3D());
 	}
 
 
 	return ModifyBoneIndex;
 }
 
+void FAnimNode_KawaiiPhysics::InitChildIndices()
+{
+	// Children are added after their parent in increasing index order, so filling the ranges in bone order keeps it
+	for (FKawaiiPhysicsModifyBone& Bone : ModifyBones)
+	{
+		Bone.NumChildren = 0;
+	}
+	for (const FKawaiiPhysicsModifyBone& Bone : ModifyBones)
+	{
+		if (Bone.ParentIndex >= 0)
+		{
+			ModifyBones[Bone.ParentIndex].NumChildren++;
+		}
+	}
+
+	int32 NumChildIndices = 0;
+	for (FKawaiiPhysicsModifyBone& Bone : ModifyBones)
+	{
+		Bone.FirstChildIndex = NumChildIndices;
+		NumChildIndices += Bone.NumChildren;
+		Bone.NumChildren = 0;
+	}
+
+	ModifyBoneChildIndices.SetNumUninitialized(NumChildIndices, false);
+	for (int32 i = 0; i < ModifyBones.Num(); ++i)
+	{
+		if (const int32 ParentIndex = ModifyBones[i].ParentIndex; ParentIndex >= 0)
+		{
+			FKawaiiPhysicsModifyBone& Parent = ModifyBones[ParentIndex];
+			ModifyBoneChildIndices[Parent.FirstChildIndex + Parent.NumChildren++] = i;
+		}
+	}
+}
+
 int32 FAnimNode_KawaiiPhysics::CollectChildBones(const FReferenceSkeleton& RefSkeleton, int32 ParentBoneIndex,
                                                  TArray<int32>& Children) const
 {
@@ -488,7 +1011,7 @@ void FAnimNode_KawaiiPhysics::CalcBoneLength(FKawaiiPhysicsModifyBone& Bone, con
 		if (!Bone.bDummy)
 		{
 			Bone.LengthFromRoot = ModifyBones[Bone.ParentIndex].LengthFromRoot
-				+ RefBonePose[Bone.BoneRef.BoneIndex].GetLocation().Size();
+				+ RefBonePose[ModifyBoneRefs[Bone.Index].BoneIndex].GetLocation().Size();
 		}
 		else
 		{
@@ -498,7 +1021,7 @@ void FAnimNode_KawaiiPhysics::CalcBoneLength(FKawaiiPhysicsModifyBone& Bone, con
 		TotalBoneLength = FMath::Max(TotalBoneLength, Bone.LengthFromRoot);
 	}
 
-	for (const int32 ChildIndex : Bone.ChildIndexs)
+	for (const int32 ChildIndex : GetChildIndices(Bone))
 	{
 		CalcBoneLength(ModifyBones[ChildIndex], RefBonePose);
 	}
@@ -566,143 +1089,335 @@ void FAnimNode_KawaiiPhysics::UpdatePhysicsSettingsOfModifyBones()
 }
 
 
-void FAnimNode_KawaiiPhysics::UpdateSphericalLimits(TArray<FSphericalLimit>& Limits, FComponentSpacePoseContext& Output,
-                                                    const FBoneContainer& BoneContainer,
-                                                    const FTransform& ComponentTransform)
+void FAnimNode_KawaiiPhysics::UpdateSharedColliders(FComponentSpacePoseContext& Output)
 {
-	for (auto& Sphere : Limits)
-	{
-		SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdateSphericalLimit);
+	bool bShare = bShareLimitsDataAsset && LimitsDataAsset;
+#if WITH_EDITOR
+	// The AnimBP editor's edit mode draws and selects this node's instances
+	bShare &= !(GUnrealEd && !GUnrealEd->IsPlayingSessionInEditor());
+#endif
 
-		if (Sphere.DrivingBone.IsValidToEvaluate(BoneContainer))
+	if (!bShare)
+	{
+		if (SharedColliders)
 		{
-			const FCompactPoseBoneIndex CompactPoseIndex = Sphere.DrivingBone.GetCompactPoseIndex(BoneContainer);
-			FTransform BoneTransform = Output.Pose.GetComponentSpaceTransform(CompactPoseIndex);
+			SharedColliders.Reset();
+			ApplyLimitsDataAsset();
+		}
+		return;
+	}
+
+	if (!SharedColliders || SharedColliders->GetLimitsDataAsset() != LimitsDataAsset)
+	{
+		SharedColliders = FKawaiiPhysicsColliderSet::FindOrAdd(Output.AnimInstanceProxy, LimitsDataAsset);
+		SphericalLimitsDataInstances.Empty();
+		CapsuleLimitsDataInstances.Empty();
+		PlanarLimitsDataInstances.Empty();
+		AppliedLimitsDataAssetRevision = 0;
+		bPoseGatherDirty = true;
+	}
+
+	SharedColliders->Update(Output);
+}
+
+TConstArrayView<FSphericalLimit> FAnimNode_KawaiiPhysics::GetSphericalLimitsDataDefinitions() const
+{
+	return LimitsDataAsset ? TConstArrayView<FSphericalLimit>(LimitsDataAsset->SphericalLimits) : TConstArrayView<FSphericalLimit>();
+}
+
+TConstArrayView<FCapsuleLimit> FAnimNode_KawaiiPhysics::GetCapsuleLimitsDataDefinitions() const
+{
+	return LimitsDataAsset ? TConstArrayView<FCapsuleLimit>(LimitsDataAsset->CapsuleLimits) : TConstArrayView<FCapsuleLimit>();
+}
+
+TConstArrayView<FPlanarLimit> FAnimNode_KawaiiPhysics::GetPlanarLimitsDataDefinitions() const
+{
+	return LimitsDataAsset ? TConstArrayView<FPlanarLimit>(LimitsDataAsset->PlanarLimits) : TConstArrayView<FPlanarLimit>();
+}
+
+TConstArrayView<FKawaiiPhysicsLimitInstance> FAnimNode_KawaiiPhysics::GetSphericalLimitsDataInstances() const
+{
+	return SharedColliders ? SharedColliders->SphericalLimitInstances : SphericalLimitsDataInstances;
+}
+
+TConstArrayView<FKawaiiPhysicsLimitInstance> FAnimNode_KawaiiPhysics::GetCapsuleLimitsDataInstances() const
+{
+	return SharedColliders ? SharedColliders->CapsuleLimitInstances : CapsuleLimitsDataInstances;
+}
+
+TConstArrayView<FKawaiiPhysicsLimitInstance> FAnimNode_KawaiiPhysics::GetPlanarLimitsDataInstances() const
+{
+	return SharedColliders ? SharedColliders->PlanarLimitInstances : PlanarLimitsDataInstances;
+}
+
+void FAnimNode_KawaiiPhysics::UpdateSphericalLimits(TArray<FSphericalLimit>& Limits,
+                                                    const TArray<FTransform>& BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdateSphericalLimit);
+
+	for (auto& Sphere : Limits)
+	{
+		Sphere.bEnable = KawaiiPhysics::UpdateLimitTransform(Sphere, BoneTransforms);
+	}
+}
+
+void FAnimNode_KawaiiPhysics::UpdateCapsuleLimits(TArray<FCapsuleLimit>& Limits,
+                                                  const TArray<FTransform>& BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdateCapsuleLimit);
 
-			FAnimationRuntime::ConvertCSTransformToBoneSpace(ComponentTransform, Output.Pose, BoneTransform,
-			                                                 CompactPoseIndex, BCS_BoneSpace);
-			BoneTransform.SetRotation(Sphere.OffsetRotation.Quaternion() * BoneTransform.GetRotation());
-			BoneTransform.AddToTranslation(Sphere.OffsetLocation);
+	for (auto& Capsule : Limits)
+	{
+		Capsule.bEnable = KawaiiPhysics::UpdateLimitTransform(Capsule, BoneTransforms);
+		if (Capsule.bEnable)
+		{
+			const FVector3f HalfAxis = Capsule.Rotation.GetAxisZ() * Capsule.Length * 0.5f;
+			Capsule.StartPoint = Capsule.Location + HalfAxis;
+			Capsule.EndPoint = Capsule.Location - HalfAxis;
+		}
+	}
+}
 
-			FAnimationRuntime::ConvertBoneSpaceTransformToCS(ComponentTransform, Output.Pose, BoneTransform,
-			                                                 CompactPoseIndex, BCS_BoneSpace);
-			Sphere.Location = BoneTransform.GetLocation();
-			Sphere.Rotation = BoneTransform.GetRotation();
+void FAnimNode_KawaiiPhysics::UpdatePlanerLimits(TArray<FPlanarLimit>& Limits,
+                                                 const TArray<FTransform>& BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdatePlanerLimit);
 
-			Sphere.bEnable = true;
+	for (auto& Planar : Limits)
+	{
+		if (KawaiiPhysics::UpdateLimitTransform(Planar, BoneTransforms))
+		{
+			Planar.bEnable = true;
 		}
 		else
 		{
-			Sphere.bEnable = false;
+			Planar.Location = FVector3f(Planar.OffsetLocation);
+			Planar.Rotation = FQuat4f(Planar.OffsetTransform.GetRotation());
+
+			// Maybe the DrivingBone is set to empty for the floor, so keep Enable
+			// Planar.bEnable = false;
 		}
+		Planar.Rotation.Normalize();
+		Planar.Plane = FPlane4f(Planar.Location, Planar.Rotation.GetUpVector());
 	}
 }
 
-void FAnimNode_KawaiiPhysics::UpdateCapsuleLimits(TArray<FCapsuleLimit>& Limits, FComponentSpacePoseContext& Output,
-                                                  const FBoneContainer& BoneContainer,
-                                                  const FTransform& ComponentTransform)
+void FAnimNode_KawaiiPhysics::UpdateSphericalLimits(TConstArrayView<FSphericalLimit> Definitions,
+                                                    TArrayView<FKawaiiPhysicsLimitInstance> Instances,
+                                                    const TArray<FTransform>& BoneTransforms)
 {
-	for (auto& Capsule : Limits)
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdateSphericalLimit);
+
+	for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
 	{
-		SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdateCapsuleLimit);
+		FKawaiiPhysicsLimitInstance& Sphere = Instances[i];
+		Sphere.bEnable = KawaiiPhysics::UpdateLimitTransform(Definitions[i].OffsetTransform, Sphere.PoseGatherSlot,
+		                                                     BoneTransforms, Sphere.Location, Sphere.Rotation);
+	}
+}
 
-		if (Capsule.DrivingBone.IsValidToEvaluate(BoneContainer))
-		{
-			const FCompactPoseBoneIndex CompactPoseIndex = Capsule.DrivingBone.GetCompactPoseIndex(BoneContainer);
-			FTransform BoneTransform = Output.Pose.GetComponentSpaceTransform(CompactPoseIndex);
+void FAnimNode_KawaiiPhysics::UpdateCapsuleLimits(TConstArrayView<FCapsuleLimit> Definitions,
+                                                  TArrayView<FKawaiiPhysicsLimitInstance> Instances,
+                                                  const TArray<FTransform>& BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdateCapsuleLimit);
 
-			FAnimationRuntime::ConvertCSTransformToBoneSpace(ComponentTransform, Output.Pose, BoneTransform,
-			                                                 CompactPoseIndex, BCS_BoneSpace);
-			BoneTransform.SetRotation(Capsule.OffsetRotation.Quaternion() * BoneTransform.GetRotation());
-			BoneTransform.AddToTranslation(Capsule.OffsetLocation);
+	for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
+	{
+		FKawaiiPhysicsLimitInstance& Capsule = Instances[i];
+		Capsule.bEnable = KawaiiPhysics::UpdateLimitTransform(Definitions[i].OffsetTransform, Capsule.PoseGatherSlot,
+		                                                      BoneTransforms, Capsule.Location, Capsule.Rotation);
+		if (Capsule.bEnable)
+		{
+			const FVector3f HalfAxis = Capsule.Rotation.GetAxisZ() * Definitions[i].Length * 0.5f;
+			Capsule.StartPoint = Capsule.Location + HalfAxis;
+			Capsule.EndPoint = Capsule.Location - HalfAxis;
+		}
+	}
+}
 
-			FAnimationRuntime::ConvertBoneSpaceTransformToCS(ComponentTransform, Output.Pose, BoneTransform,
-			                                                 CompactPoseIndex, BCS_BoneSpace);
-			Capsule.Location = BoneTransform.GetLocation();
-			Capsule.Rotation = BoneTransform.GetRotation();
+void FAnimNode_KawaiiPhysics::UpdatePlanerLimits(TConstArrayView<FPlanarLimit> Definitions,
+                                                 TArrayView<FKawaiiPhysicsLimitInstance> Instances,
+                                                 const TArray<FTransform>& BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdatePlanerLimit);
 
-			Capsule.bEnable = true;
-		}
-		else
+	for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
+	{
+		const FPlanarLimit& Definition = Definitions[i];
+		FKawaiiPhysicsLimitInstance& Planar = Instances[i];
+		if (!KawaiiPhysics::UpdateLimitTransform(Definition.OffsetTransform, Planar.PoseGatherSlot, BoneTransforms,
+		                                         Planar.Location, Planar.Rotation))
 		{
-			Capsule.bEnable = false;
+			// Maybe the DrivingBone is set to empty for the floor
+			Planar.Location = FVector3f(Definition.OffsetLocation);
+			Planar.Rotation = FQuat4f(Definition.OffsetTransform.GetRotation());
 		}
+		Planar.bEnable = true;
+		Planar.Rotation.Normalize();
+		Planar.Plane = FPlane4f(Planar.Location, Planar.Rotation.GetUpVector());
 	}
 }
 
-void FAnimNode_KawaiiPhysics::UpdatePlanerLimits(TArray<FPlanarLimit>& Limits, FComponentSpacePoseContext& Output,
-                                                 const FBoneContainer& BoneContainer,
-                                                 const FTransform& ComponentTransform)
+void FAnimNode_KawaiiPhysics::InitPoseGather(const FBoneContainer& BoneContainer)
 {
-	for (auto& Planar : Limits)
-	{
-		SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdatePlanerLimit);
+	PoseGatherIndices.Reset(ModifyBones.Num());
 
-		if (Planar.DrivingBone.IsValidToEvaluate(BoneContainer))
+	// A bone shared by several ModifyBones/limits is fetched once
+	TMap<int32, int32> SlotByCompactPoseIndex;
+	for (const auto& Bone : ModifyBones)
+	{
+		const FCompactPoseBoneIndex CompactPoseIndex = Bone.bDummy
+			                                               ? FCompactPoseBoneIndex(INDEX_NONE)
+			                                               : ModifyBoneRefs[Bone.Index].GetCompactPoseIndex(
+				                                               BoneContainer);
+		if (CompactPoseIndex.IsValid())
 		{
-			const FCompactPoseBoneIndex CompactPoseIndex = Planar.DrivingBone.GetCompactPoseIndex(BoneContainer);
-			FTransform BoneTransform = Output.Pose.GetComponentSpaceTransform(CompactPoseIndex);
+			SlotByCompactPoseIndex.Add(CompactPoseIndex.GetInt(), PoseGatherIndices.Num());
+		}
+		PoseGatherIndices.Add(CompactPoseIndex);
+	}
 
-			FAnimationRuntime::ConvertCSTransformToBoneSpace(ComponentTransform, Output.Pose, BoneTransform,
-			                                                 CompactPoseIndex, BCS_BoneSpace);
-			BoneTransform.SetRotation(Planar.OffsetRotation.Quaternion() * BoneTransform.GetRotation());
-			BoneTransform.AddToTranslation(Planar.OffsetLocation);
+	// Built on the game thread from names only
+	for (auto& Sphere : SphericalLimitsPhysicsAsset)
+	{
+		Sphere.DrivingBone.Initialize(BoneContainer);
+	}
+	for (auto& Capsule : CapsuleLimitsPhysicsAsset)
+	{
+		Capsule.DrivingBone.Initialize(BoneContainer);
+	}
 
-			FAnimationRuntime::ConvertBoneSpaceTransformToCS(ComponentTransform, Output.Pose, BoneTransform,
-			                                                 CompactPoseIndex, BCS_BoneSpace);
-			Planar.Location = BoneTransform.GetLocation();
-			Planar.Rotation = BoneTransform.GetRotation();
-			Planar.Rotation.Normalize();
-			Planar.Plane = FPlane(Planar.Location, Planar.Rotation.GetUpVector());
+	PoseGatherNumLimits = 0;
+	auto AddLimits = [&](auto& Limits)
+	{
+		for (auto& Limit : Limits)
+		{
+			Limit.OffsetTransform = FTransform(Limit.OffsetRotation, Limit.OffsetLocation);
+			Limit.PoseGatherSlot = INDEX_NONE;
+			if (!Limit.DrivingBone.IsValidToEvaluate(BoneContainer))
+			{
+				continue;
+			}
 
-			Planar.bEnable = true;
+			const FCompactPoseBoneIndex CompactPoseIndex = Limit.DrivingBone.GetCompactPoseIndex(BoneContainer);
+			if (const int32* Slot = SlotByCompactPoseIndex.Find(CompactPoseIndex.GetInt()))
+			{
+				Limit.PoseGatherSlot = *Slot;
+			}
+			else
+			{
+				Limit.PoseGatherSlot = SlotByCompactPoseIndex.Add(CompactPoseIndex.GetInt(),
+				                                                  PoseGatherIndices.Add(CompactPoseIndex));
+			}
 		}
-		else
+		PoseGatherNumLimits += Limits.Num();
+	};
+	AddLimits(SphericalLimits);
+	AddLimits(CapsuleLimits);
+	AddLimits(PlanarLimits);
+	AddLimits(SphericalLimitsPhysicsAsset);
+	AddLimits(CapsuleLimitsPhysicsAsset);
+
+	// The LimitsDataAsset is shared by every node using it : only the slots are resolved here
+	auto AddLimitInstances = [&](auto Definitions, TArray<FKawaiiPhysicsLimitInstance>& Instances)
+	{
+		for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
 		{
-			Planar.Location = Planar.OffsetLocation;
-			Planar.Rotation = Planar.OffsetRotation.Quaternion();
-			Planar.Rotation.Normalize();
-			Planar.Plane = FPlane(Planar.Location, Planar.Rotation.GetUpVector());
+			FKawaiiPhysicsLimitInstance& Instance = Instances[i];
+			Instance.PoseGatherSlot = INDEX_NONE;
 
-			// Maybe the DrivingBone is set to empty for the floor, so keep Enable
-			// Planar.bEnable = false;
+			FBoneReference DrivingBone = Definitions[i].DrivingBone;
+			if (!DrivingBone.Initialize(BoneContainer) || !DrivingBone.IsValidToEvaluate(BoneContainer))
+			{
+				continue;
+			}
+
+			const FCompactPoseBoneIndex CompactPoseIndex = DrivingBone.GetCompactPoseIndex(BoneContainer);
+			if (const int32* Slot = SlotByCompactPoseIndex.Find(CompactPoseIndex.GetInt()))
+			{
+				Instance.PoseGatherSlot = *Slot;
+			}
+			else
+			{
+				Instance.PoseGatherSlot = SlotByCompactPoseIndex.Add(CompactPoseIndex.GetInt(),
+				                                                     PoseGatherIndices.Add(CompactPoseIndex));
+			}
 		}
+		PoseGatherNumLimits += Instances.Num();
+	};
+	AddLimitInstances(GetSphericalLimitsDataDefinitions(), SphericalLimitsDataInstances);
+	AddLimitInstances(GetCapsuleLimitsDataDefinitions(), CapsuleLimitsDataInstances);
+	AddLimitInstances(GetPlanarLimitsDataDefinitions(), PlanarLimitsDataInstances);
+
+	PoseGatherBoneContainerSerial = BoneContainer.GetSerialNumber();
+	bPoseGatherDirty = false;
+}
+
+void FAnimNode_KawaiiPhysics::GatherPoseTransforms(FComponentSpacePoseContext& Output,
+                                                   const FBoneContainer& BoneContainer)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_GatherPose);
+
+	const int32 NumLimits = SphericalLimits.Num() + SphericalLimitsDataInstances.Num() + CapsuleLimits.Num() +
+		CapsuleLimitsDataInstances.Num() + PlanarLimits.Num() + PlanarLimitsDataInstances.Num() +
+		SphericalLimitsPhysicsAsset.Num() + CapsuleLimitsPhysicsAsset.Num();
+	if (bPoseGatherDirty || PoseGatherBoneContainerSerial != BoneContainer.GetSerialNumber() ||
+		PoseGatherNumLimits != NumLimits || PoseGatherIndices.Num() < ModifyBones.Num())
+	{
+		InitPoseGather(BoneContainer);
 	}
+
+	BoneTransformsCS.SetNumUninitialized(PoseGatherIndices.Num());
+	int32 NumFetched = 0;
+	for (int32 Slot = 0; Slot < PoseGatherIndices.Num(); ++Slot)
+	{
+		if (PoseGatherIndices[Slot].IsValid())
+		{
+			BoneTransformsCS[Slot] = Output.Pose.GetComponentSpaceTransform(PoseGatherIndices[Slot]);
+			++NumFetched;
+		}
+	}
+	INC_DWORD_STAT_BY(STAT_KawaiiPhysics_PoseTransformsFetched, NumFetched);
 }
 
-void FAnimNode_KawaiiPhysics::UpdateModifyBonesPoseTransform(FComponentSpacePoseContext& Output,
-                                                             const FBoneContainer& BoneContainer)
+void FAnimNode_KawaiiPhysics::UpdateModifyBonesPoseTransform()
 {
-	for (auto& Bone : ModifyBones)
+	// BoneTransformsCS is already gathered, fill in dummy and missing bones. Parents are always before their children.
+	// Missing bones keep the pose of the previous frame
+	for (const auto& Bone : ModifyBones)
 	{
 		if (!Bone.bDummy)
 		{
-			Bone.UpdatePoseTransform(BoneContainer, Output.Pose, ResetBoneTransformWhenBoneNotFound);
+			// Reset bone location and rotation may cause trouble when switching between skeleton LODs #44
+			if (!PoseGatherIndices[Bone.Index].IsValid() && ResetBoneTransformWhenBoneNotFound)
+			{
+				BoneTransformsCS[Bone.Index] = FTransform::Identity;
+			}
 		}
 		else
 		{
-			auto ParentBone = ModifyBones[Bone.ParentIndex];
-			Bone.PoseLocation = ParentBone.PoseLocation + GetBoneForwardVector(ParentBone.PoseRotation) *
-				DummyBoneLength;
-			Bone.PoseRotation = ParentBone.PoseRotation;
-			Bone.PoseScale = ParentBone.PoseScale;
+			FTransform& PoseTransform = BoneTransformsCS[Bone.Index];
+			PoseTransform = BoneTransformsCS[Bone.ParentIndex];
+			PoseTransform.AddToTranslation(
+				FVector(GetBoneForwardVector(GetPoseRotation(Bone.ParentIndex)) * DummyBoneLength));
 		}
 	}
 }
 
 void FAnimNode_KawaiiPhysics::UpdateSkelCompMove(const FTransform& ComponentTransform)
 {
-	SkelCompMoveVector = ComponentTransform.InverseTransformPosition(PreSkelCompTransform.GetLocation());
+	SkelCompMoveVector = FVector3f(ComponentTransform.InverseTransformPosition(PreSkelCompTransform.GetLocation()));
 	if (SkelCompMoveVector.SizeSquared() > TeleportDistanceThreshold * TeleportDistanceThreshold)
 	{
-		SkelCompMoveVector = FVector::ZeroVector;
+		SkelCompMoveVector = FVector3f::ZeroVector;
 	}
 
-	SkelCompMoveRotation = ComponentTransform.InverseTransformRotation(PreSkelCompTransform.GetRotation());
+	SkelCompMoveRotation = FQuat4f(ComponentTransform.InverseTransformRotation(PreSkelCompTransform.GetRotation()));
 	if (TeleportRotationThreshold >= 0 && FMath::RadiansToDegrees(SkelCompMoveRotation.GetAngle()) >
 		TeleportRotationThreshold)
 	{
-		SkelCompMoveRotation = FQuat::Identity;
+		SkelCompMoveRotation = FQuat4f::Identity;
 	}
 
 	PreSkelCompTransform = ComponentTransform;
@@ -718,12 +1433,10 @@ void FAnimNode_KawaiiPhysics::SimulateModifyBones(FComponentSpacePoseContext& Ou
 		return;
 	}
 
-	const USkeletalMeshComponent* SkelComp = Output.AnimInstanceProxy->GetSkelMeshComponent();
-
 	// Save Prev/Pose Info , Check SkipSimulate
 	for (FKawaiiPhysicsModifyBone& Bone : ModifyBones)
 	{
-		if (Bone.BoneRef.BoneIndex < 0 && !Bone.bDummy)
+		if (!Bone.bDummy && ModifyBoneRefs[Bone.Index].BoneIndex < 0)
 		{
 			Bone.bSkipSimulate = true;
 			continue;
@@ -733,46 +1446,67 @@ void FAnimNode_KawaiiPhysics::SimulateModifyBones(FComponentSpacePoseContext& Ou
 		{
 			Bone.bSkipSimulate = true;
 			Bone.PrevLocation = Bone.Location;
-			Bone.Location = Bone.PoseLocation;
+			Bone.Location = GetPoseLocation(Bone.Index);
 			continue;
 		}
 
 		Bone.bSkipSimulate = false;
 	}
 
-	// External Force
-	// NOTE: if use foreach, you may get issue ( Array has changed during ranged-for iteration )
-	for (int i = 0; i < CustomExternalForces.Num(); ++i)
+	// Simulate
+	const FVector3f GravityCS = FVector3f(ComponentTransform.InverseTransformVector(Gravity));
+	for (FKawaiiPhysicsModifyBone& Bone : ModifyBones)
 	{
-		if (CustomExternalForces[i])
+		if (Bone.bSkipSimulate)
 		{
-			CustomExternalForces[i]->PreApply(*this, SkelComp);
+			continue;
 		}
+		Simulate(Bone, GravityCS);
 	}
+
+	// External Force : one batch call per force for the whole chain
 	for (int i = 0; i < ExternalForces.Num(); ++i)
 	{
 		if (ExternalForces[i].IsValid())
 		{
-			auto& Force = ExternalForces[i].GetMutable<FKawaiiPhysics_ExternalForce>();
-			Force.PreApply(*this, SkelComp);
+			if (const auto ExForce = ExternalForces[i].GetMutablePtr<FKawaiiPhysics_ExternalForce>();
+				ExForce->bIsEnabled && ExForce->HasApplicableBone())
+			{
+				ExForce->ApplyBatch(ModifyBones, *this, Output, BoneTransformsCS);
+			}
+		}
+	}
+	for (int i = 0; i < CustomExternalForces.Num(); ++i)
+	{
+		if (CustomExternalForces[i] && CustomExternalForces[i]->bIsEnabled)
+		{
+			CustomExternalForces[i]->ApplyBatch(ModifyBones, *this, Output, BoneTransformsCS);
 		}
 	}
 
-	// Simulate
+	// Pull to Pose Location
 	const float Exponent = TargetFramerate * DeltaTime;
-	const FVector GravityCS = ComponentTransform.InverseTransformVector(Gravity);
-	const UWorld* World = SkelComp ? SkelComp->GetWorld() : nullptr;
-	const FSceneInterface* Scene = World && World->Scene ? World->Scene : nullptr;
 	for (FKawaiiPhysicsModifyBone& Bone : ModifyBones)
 	{
 		if (Bone.bSkipSimulate)
 		{
 			continue;
 		}
-		Simulate(Bone, Scene, ComponentTransform, GravityCS, Exponent, SkelComp, Output);
+
+		const FKawaiiPhysicsModifyBone& ParentBone = ModifyBones[Bone.ParentIndex];
+		const FVector3f BaseLocation = ParentBone.Location +
+			(GetPoseLocation(Bone.Index) - GetPoseLocation(Bone.ParentIndex));
+		Bone.Location += (BaseLocation - Bone.Location) *
+			(1.0f - FMath::Pow(1.0f - Bone.PhysicsSettings.Stiffness, Exponent));
 	}
 
 	// Adjust by collisions
+	const TConstArrayView<FSphericalLimit> SphericalLimitsData = GetSphericalLimitsDataDefinitions();
+	const TConstArrayView<FCapsuleLimit> CapsuleLimitsData = GetCapsuleLimitsDataDefinitions();
+	const TConstArrayView<FKawaiiPhysicsLimitInstance> SphericalLimitsDataInstancesRef =
+		GetSphericalLimitsDataInstances();
+	const TConstArrayView<FKawaiiPhysicsLimitInstance> CapsuleLimitsDataInstancesRef = GetCapsuleLimitsDataInstances();
+	const TConstArrayView<FKawaiiPhysicsLimitInstance> PlanarLimitsDataInstancesRef = GetPlanarLimitsDataInstances();
 	for (FKawaiiPhysicsModifyBone& Bone : ModifyBones)
 	{
 		if (Bone.bSkipSimulate)
@@ -783,24 +1517,49 @@ void FAnimNode_KawaiiPhysics::SimulateModifyBones(FComponentSpacePoseContext& Ou
 		SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_AdjustByCollision);
 
 		AdjustBySphereCollision(Bone, SphericalLimits);
-		AdjustBySphereCollision(Bone, SphericalLimitsData);
+		AdjustBySphereCollision(Bone, SphericalLimitsData, SphericalLimitsDataInstancesRef);
 		AdjustByCapsuleCollision(Bone, CapsuleLimits);
-		AdjustByCapsuleCollision(Bone, CapsuleLimitsData);
+		AdjustByCapsuleCollision(Bone, CapsuleLimitsData, CapsuleLimitsDataInstancesRef);
 		AdjustByPlanerCollision(Bone, PlanarLimits);
-		AdjustByPlanerCollision(Bone, PlanarLimitsData);
+		AdjustByPlanerCollision(Bone, PlanarLimitsDataInstancesRef);
+		AdjustBySphereCollision(Bone, SphericalLimitsPhysicsAsset);
+		AdjustByCapsuleCollision(Bone, CapsuleLimitsPhysicsAsset);
 		if (bAllowWorldCollision)
 		{
-			AdjustByWorldCollision(Bone, SkelComp);
+			AdjustByWorldCollision(Bone);
 		}
 	}
 
-	// Adjust by Bone Constraints After Collision
-	if (BoneConstraintIterationCountAfterCollision > 0)
+	if (bUseSegmentCollision)
 	{
-		for (FModifyBoneConstraint& BoneConstraint : MergedBoneConstraints)
+		SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_SegmentCollision);
+
+		for (FKawaiiPhysicsModifyBone& Bone : ModifyBones)
 		{
-			BoneConstraint.Lambda = 0.0f;
+			if (Bone.bSkipSimulate || Bone.ParentIndex < 0 || Bone.PhysicsSettings.Radius <= 0.0f)
+			{
+				continue;
+			}
+
+			FKawaiiPhysicsModifyBone& ParentBone = ModifyBones[Bone.ParentIndex];
+			AdjustSegmentBySphereCollision(Bone, ParentBone, SphericalLimits);
+			AdjustSegmentBySphereCollision(Bone, ParentBone, SphericalLimitsData, SphericalLimitsDataInstancesRef);
+			AdjustSegmentBySphereCollision(Bone, ParentBone, SphericalLimitsPhysicsAsset);
+			AdjustSegmentByCapsuleCollision(Bone, ParentBone, CapsuleLimits);
+			AdjustSegmentByCapsuleCollision(Bone, ParentBone, CapsuleLimitsData, CapsuleLimitsDataInstancesRef);
+			AdjustSegmentByCapsuleCollision(Bone, ParentBone, CapsuleLimitsPhysicsAsset);
 		}
+	}
+
+	if (bEnableSelfCollision)
+	{
+		AdjustBySelfCollision();
+	}
+
+	// Adjust by Bone Constraints After Collision
+	if (BoneConstraintIterationCountAfterCollision > 0 && !RuntimeBoneConstraints.IsEmpty())
+	{
+		UpdateBoneConstraintCompliance();
 		for (int i = 0; i < BoneConstraintIterationCountAfterCollision; ++i)
 		{
 			AdjustByBoneConstraints();
@@ -824,31 +1583,26 @@ void FAnimNode_KawaiiPhysics::SimulateModifyBones(FComponentSpacePoseContext& Ou
 		AdjustByPlanarConstraint(Bone, ParentBone);
 
 		// Restore Bone Length
-		const float BoneLength = (Bone.PoseLocation - ParentBone.PoseLocation).Size();
+		const float BoneLength = (GetPoseLocation(Bone.Index) - GetPoseLocation(Bone.ParentIndex)).Size();
 		Bone.Location = (Bone.Location - ParentBone.Location).GetSafeNormal() * BoneLength + ParentBone.Location;
 	}
 
 	DeltaTimeOld = DeltaTime;
 }
 
-void FAnimNode_KawaiiPhysics::Simulate(FKawaiiPhysicsModifyBone& Bone, const FSceneInterface* Scene,
-                                       const FTransform& ComponentTransform, const FVector& GravityCS,
-                                       const float& Exponent, const USkeletalMeshComponent* SkelComp,
-                                       FComponentSpacePoseContext& Output)
+void FAnimNode_KawaiiPhysics::Simulate(FKawaiiPhysicsModifyBone& Bone, const FVector3f& GravityCS)
 {
 	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_Simulate);
 
-	const FKawaiiPhysicsModifyBone& ParentBone = ModifyBones[Bone.ParentIndex];
-
 	// Move using Velocity( = movement amount in pre frame ) and Damping
-	FVector Velocity = (Bone.Location - Bone.PrevLocation) / DeltaTimeOld;
+	FVector3f Velocity = (Bone.Location - Bone.PrevLocation) / DeltaTimeOld;
 	Bone.PrevLocation = Bone.Location;
 	Velocity *= (1.0f - Bone.PhysicsSettings.Damping);
 
 	// wind
-	if (bEnableWind && Scene)
+	if (bEnableWind && GameThreadInput.bWindSampled)
 	{
-		Velocity += GetWindVelocity(Scene, ComponentTransform, Bone) * TargetFramerate;
+		Velocity += GetWindVelocity(Bone) * TargetFramerate;
 	}
 	Bone.Location += Velocity * DeltaTime;
 
@@ -861,124 +1615,87 @@ void FAnimNode_KawaiiPhysics::Simulate(FKawaiiPhysicsModifyBone& Bone, const FSc
 
 	// Gravity
 	// TODO:Migrate if there are more good method (Currently copying AnimDynamics implementation)
-	Bone.Location += 0.5 * GravityCS * DeltaTime * DeltaTime;
+	Bone.Location += 0.5f * GravityCS * DeltaTime * DeltaTime;
+}
 
-	// External Force
-	// NOTE: if use foreach, you may get issue ( Array has changed during ranged-for iteration )
-	for (int i = 0; i < CustomExternalForces.Num(); ++i)
+void FAnimNode_KawaiiPhysics::SampleWind(const FSceneInterface* Scene, const FTransform& ComponentTransform)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_SampleWind);
+
+	// Use the previous pose : ModifyBones are not touched by the worker thread during PreUpdate
+	FVector RootLocation = FVector::ZeroVector;
+	FVector TipLocation = FVector::ZeroVector;
+	if (ModifyBones.Num() > 0)
 	{
-		if (CustomExternalForces[i] && CustomExternalForces[i]->bIsEnabled)
+		RootLocation = GetBoneTransformCS(0).GetLocation();
+		TipLocation = RootLocation;
+		float TipLength = 0.0f;
+		for (const FKawaiiPhysicsModifyBone& Bone : ModifyBones)
 		{
-			FTransform BoneTM = FTransform::Identity;
-			if (Bone.bDummy)
-			{
-				BoneTM = Output.Pose.GetComponentSpaceTransform(
-					ParentBone.BoneRef.GetCompactPoseIndex(Output.Pose.GetPose().GetBoneContainer()));
-			}
-			else
+			if (Bone.LengthFromRoot > TipLength)
 			{
-				BoneTM = Output.Pose.GetComponentSpaceTransform(
-					Bone.BoneRef.GetCompactPoseIndex(Output.Pose.GetPose().GetBoneContainer()));
+				TipLength = Bone.LengthFromRoot;
+				TipLocation = GetBoneTransformCS(Bone.Index).GetLocation();
 			}
-			CustomExternalForces[i]->Apply(*this, Bone.Index, SkelComp, BoneTM);
 		}
 	}
 
-	for (int i = 0; i < ExternalForces.Num(); ++i)
+	auto GetWindVelocityCS = [Scene, &ComponentTransform](const FVector& LocationCS)
 	{
-		if (ExternalForces[i].IsValid())
-		{
-			if (const auto ExForce = ExternalForces[i].GetMutablePtr<FKawaiiPhysics_ExternalForce>();
-				ExForce->bIsEnabled)
-			{
-				if (ExForce->ExternalForceSpace == EExternalForceSpace::BoneSpace)
-				{
-					FTransform BoneTM = FTransform::Identity;
-					if (Bone.bDummy)
-					{
-						BoneTM = Output.Pose.GetComponentSpaceTransform(
-							ParentBone.BoneRef.GetCompactPoseIndex(Output.Pose.GetPose().GetBoneContainer()));
-					}
-					else
-					{
-						BoneTM = Output.Pose.GetComponentSpaceTransform(
-							Bone.BoneRef.GetCompactPoseIndex(Output.Pose.GetPose().GetBoneContainer()));
-					}
-
-					ExForce->Apply(Bone, *this, Output, BoneTM);
-				}
-				else
-				{
-					ExForce->Apply(Bone, *this, Output);
-				}
-			}
-		}
-	}
+		FVector WindDirection = FVector::ZeroVector;
+		float WindSpeed = 0.0f;
+		float WindMinGust = 0.0f;
+		float WindMaxGust = 0.0f;
+		Scene->GetWindParameters_GameThread(ComponentTransform.TransformPosition(LocationCS), WindDirection,
+		                                    WindSpeed, WindMinGust, WindMaxGust);
+		return FVector3f(ComponentTransform.InverseTransformVector(WindDirection) * WindSpeed);
+	};
 
-	// // Pull to Pose Location
-	const FVector BaseLocation = ParentBone.Location + (Bone.PoseLocation - ParentBone.PoseLocation);
-	Bone.Location += (BaseLocation - Bone.Location) *
-		(1.0f - FMath::Pow(1.0f - Bone.PhysicsSettings.Stiffness, Exponent));
+	GameThreadInput.WindVelocityAtRoot = GetWindVelocityCS(RootLocation);
+	GameThreadInput.WindVelocityAtTip = TipLocation.Equals(RootLocation)
+		                                    ? GameThreadInput.WindVelocityAtRoot
+		                                    : GetWindVelocityCS(TipLocation);
+	GameThreadInput.bWindSampled = true;
 }
 
-FVector FAnimNode_KawaiiPhysics::GetWindVelocity(const FSceneInterface* Scene, const FTransform& ComponentTransform,
-                                                 const FKawaiiPhysicsModifyBone& Bone) const
+FVector3f FAnimNode_KawaiiPhysics::GetWindVelocity(const FKawaiiPhysicsModifyBone& Bone) const
 {
 	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_GetWindVelocity);
 
-	FVector WindDirection = FVector::ZeroVector;
-	float WindSpeed = 0.0f;
-	float WindMinGust = 0.0f;
-	float WindMaxGust = 0.0f;
-
-	Scene->GetWindParameters_GameThread(ComponentTransform.TransformPosition(Bone.PoseLocation), WindDirection,
-	                                    WindSpeed, WindMinGust, WindMaxGust);
-	WindDirection = ComponentTransform.Inverse().TransformVector(WindDirection);
-	FVector WindVelocity = WindDirection * WindSpeed * WindScale;
+	const float LengthRate = TotalBoneLength > 0.0f ? Bone.LengthFromRoot / TotalBoneLength : 0.0f;
+	FVector3f WindVelocity = FMath::Lerp(GameThreadInput.WindVelocityAtRoot, GameThreadInput.WindVelocityAtTip,
+	                                         LengthRate) * WindScale;
 
 	// TODO:Migrate if there are more good method (Currently copying AnimDynamics implementation)
-	WindVelocity *= FMath::FRandRange(0.0f, 2.0f);
+	WindVelocity *= RandomStream.FRandRange(0.0f, 2.0f);
 
 	return WindVelocity;
 }
 
-void FAnimNode_KawaiiPhysics::AdjustByWorldCollision(FKawaiiPhysicsModifyBone& Bone,
-                                                     const USkeletalMeshComponent* OwningComp)
+void FAnimNode_KawaiiPhysics::AdjustByWorldCollision(FKawaiiPhysicsModifyBone& Bone)
 {
 	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_WorldCollision);
 
-	if (!OwningComp || Bone.ParentIndex < 0)
+	const FKawaiiPhysicsGameThreadInput& Input = GameThreadInput;
+	if (!Input.bValid || Bone.ParentIndex < 0)
 	{
 		return;
 	}
 
-	/** the trace is not done in game thread, so TraceTag does not draw debug traces*/
-	FCollisionQueryParams Params(SCENE_QUERY_STAT(KawaiiCollision));
+	const FCollisionQueryParams& Params = Input.CollisionQueryParams;
+	const ECollisionChannel TraceChannel = Input.CollisionChannel;
+	const FCollisionResponseParams& ResponseParams = Input.CollisionResponseParams;
+	const FTransform& CompTransform = Input.ComponentTransform;
+	const FVector PrevLocationWS = CompTransform.TransformPosition(FVector(Bone.PrevLocation));
+	const FVector LocationWS = CompTransform.TransformPosition(FVector(Bone.Location));
 
-	if (bIgnoreSelfComponent)
-	{
-		Params.AddIgnoredComponent(OwningComp);
-	}
-
-	// Get collision settings from component	
-	ECollisionChannel TraceChannel = bOverrideCollisionParams
-		                                 ? CollisionChannelSettings.GetObjectType()
-		                                 : OwningComp->GetCollisionObjectType();
-	FCollisionResponseParams ResponseParams = bOverrideCollisionParams
-		                                          ? FCollisionResponseParams(
-			                                          CollisionChannelSettings.GetResponseToChannels())
-		                                          : FCollisionResponseParams(
-			                                          OwningComp->GetCollisionResponseToChannels());
-	auto CompTransform = OwningComp->GetComponentTransform();
-
-	if (const UWorld* World = OwningComp->GetWorld())
+	if (const UWorld* World = Input.World)
 	{
 		if (bIgnoreSelfComponent)
 		{
 			// Do sphere sweep
 			FHitResult Result;
-			bool bHit = World->SweepSingleByChannel(Result, CompTransform.TransformPosition(Bone.PrevLocation),
-			                                        CompTransform.TransformPosition(Bone.Location), FQuat::Identity,
+			bool bHit = World->SweepSingleByChannel(Result, PrevLocationWS, LocationWS, FQuat::Identity,
 			                                        TraceChannel,
 			                                        FCollisionShape::MakeSphere(Bone.PhysicsSettings.Radius), Params,
 			                                        ResponseParams);
@@ -986,12 +1703,12 @@ void FAnimNode_KawaiiPhysics::AdjustByWorldCollision(FKawaiiPhysicsModifyBone& B
 			{
 				if (Result.bStartPenetrating)
 				{
-					Bone.Location = CompTransform.InverseTransformPosition(
-						CompTransform.TransformPosition(Bone.Location) + (Result.Normal * Result.PenetrationDepth));
+					Bone.Location = FVector3f(CompTransform.InverseTransformPosition(
+						LocationWS + (Result.Normal * Result.PenetrationDepth)));
 				}
 				else
 				{
-					Bone.Location = CompTransform.InverseTransformPosition(Result.Location);
+					Bone.Location = FVector3f(CompTransform.InverseTransformPosition(Result.Location));
 				}
 			}
 		}
@@ -999,8 +1716,7 @@ void FAnimNode_KawaiiPhysics::AdjustByWorldCollision(FKawaiiPhysicsModifyBone& B
 		{
 			// Do sphere sweep and ignore bones later
 			TArray<FHitResult> Results;
-			bool bHit = World->SweepMultiByChannel(Results, CompTransform.TransformPosition(Bone.PrevLocation),
-			                                       CompTransform.TransformPosition(Bone.Location), FQuat::Identity,
+			bool bHit = World->SweepMultiByChannel(Results, PrevLocationWS, LocationWS, FQuat::Identity,
 			                                       TraceChannel,
 			                                       FCollisionShape::MakeSphere(Bone.PhysicsSettings.Radius), Params,
 			                                       ResponseParams);
@@ -1013,9 +1729,9 @@ void FAnimNode_KawaiiPhysics::AdjustByWorldCollision(FKawaiiPhysicsModifyBone& B
 					{
 						//should we ignore this hit?
 						IsIgnoreHit = false;
-						if (Hit.Component == OwningComp && Hit.BoneName != NAME_None)
+						if (Hit.Component == Input.OwningComp && Hit.BoneName != NAME_None)
 						{
-							IsIgnoreHit = Hit.BoneName == Bone.BoneRef.BoneName;
+							IsIgnoreHit = Hit.BoneName == GetModifyBoneName(Bone.Index);
 							if (!IsIgnoreHit)
 							{
 								for (auto BoneRef : IgnoreBones)
@@ -1044,13 +1760,12 @@ void FAnimNode_KawaiiPhysics::AdjustByWorldCollision(FKawaiiPhysicsModifyBone& B
 						{
 							if (Hit.bStartPenetrating)
 							{
-								Bone.Location = CompTransform.InverseTransformPosition(
-									CompTransform.TransformPosition(Bone.Location) + (Hit.Normal * Hit.
-										PenetrationDepth));
+								Bone.Location = FVector3f(CompTransform.InverseTransformPosition(
+									LocationWS + (Hit.Normal * Hit.PenetrationDepth)));
 							}
 							else
 							{
-								Bone.Location = CompTransform.InverseTransformPosition(Hit.Location);
+								Bone.Location = FVector3f(CompTransform.InverseTransformPosition(Hit.Location));
 							}
 							break;
 						}
@@ -1061,33 +1776,194 @@ void FAnimNode_KawaiiPhysics::AdjustByWorldCollision(FKawaiiPhysicsModifyBone& B
 	}
 }
 
-void FAnimNode_KawaiiPhysics::AdjustBySphereCollision(FKawaiiPhysicsModifyBone& Bone, TArray<FSphericalLimit>& Limits)
+void FAnimNode_KawaiiPhysics::AdjustBySelfCollision()
 {
-	for (auto& Sphere : Limits)
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_SelfCollision);
+
+	const int32 NumBones = ModifyBones.Num();
+	float MaxRadius = 0.0f;
+	for (const FKawaiiPhysicsModifyBone& Bone : ModifyBones)
+	{
+		MaxRadius = FMath::Max(MaxRadius, Bone.PhysicsSettings.Radius);
+	}
+	if (NumBones < 2 || MaxRadius <= 0.0f || SelfCollisionChains.Num() != NumBones)
+	{
+		return;
+	}
+
+	// Cells are as large as the largest pair distance, so colliding bones are at most one cell apart
+	const float InvCellSize = 0.5f / MaxRadius;
+	const uint32 HashMask = FMath::RoundUpToPowerOfTwo(NumBones * 2) - 1;
+	auto GetCell = [InvCellSize](const FVector3f& Location)
 	{
-		if (!Sphere.bEnable || Sphere.Radius <= 0.0f)
+		return FIntVector(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize),
+		                  FMath::FloorToInt(Location.Z * InvCellSize));
+	};
+	auto HashCell = [HashMask](const FIntVector& Cell)
+	{
+		return (static_cast<uint32>(Cell.X) * 73856093u ^ static_cast<uint32>(Cell.Y) * 19349663u ^
+			static_cast<uint32>(Cell.Z) * 83492791u) & HashMask;
+	};
+
+	// Counting sort of the bones by cell hash : rebuilt in O(N) every frame
+	SelfCollisionCellStarts.Reset();
+	SelfCollisionCellStarts.SetNumZeroed(HashMask + 2);
+	SelfCollisionBoneCells.SetNumUninitialized(NumBones);
+	SelfCollisionSortedBones.SetNumUninitialized(NumBones);
+	for (int32 i = 0; i < NumBones; ++i)
+	{
+		SelfCollisionBoneCells[i] = HashCell(GetCell(ModifyBones[i].Location));
+		++SelfCollisionCellStarts[SelfCollisionBoneCells[i]];
+	}
+	for (uint32 Cell = 1; Cell <= HashMask + 1; ++Cell)
+	{
+		SelfCollisionCellStarts[Cell] += SelfCollisionCellStarts[Cell - 1];
+	}
+	for (int32 i = 0; i < NumBones; ++i)
+	{
+		SelfCollisionSortedBones[--SelfCollisionCellStarts[SelfCollisionBoneCells[i]]] = i;
+	}
+
+	for (int32 i = 0; i < NumBones; ++i)
+	{
+		FKawaiiPhysicsModifyBone& Bone = ModifyBones[i];
+		if (SelfCollisionChains[i] == INDEX_NONE || Bone.PhysicsSettings.Radius <= 0.0f)
 		{
 			continue;
 		}
 
-		const float LimitDistance = Bone.PhysicsSettings.Radius + Sphere.Radius;
-		if (Sphere.LimitType == ESphericalLimitType::Outer)
+		// Neighbour cells may share a hash bucket : visit each bucket once
+		TArray<uint32, TInlineAllocator<27>> VisitedBuckets;
+		const FIntVector Cell = GetCell(Bone.Location);
+		for (int32 X = -1; X <= 1; ++X)
 		{
-			if ((Bone.Location - Sphere.Location).SizeSquared() > LimitDistance * LimitDistance)
+			for (int32 Y = -1; Y <= 1; ++Y)
 			{
-				continue;
+				for (int32 Z = -1; Z <= 1; ++Z)
+				{
+					const uint32 Bucket = HashCell(Cell + FIntVector(X, Y, Z));
+					if (VisitedBuckets.Contains(Bucket))
+					{
+						continue;
+					}
+					VisitedBuckets.Add(Bucket);
+
+					for (int32 k = SelfCollisionCellStarts[Bucket]; k < SelfCollisionCellStarts[Bucket + 1]; ++k)
+					{
+						const int32 j = SelfCollisionSortedBones[k];
+						FKawaiiPhysicsModifyBone& Other = ModifyBones[j];
+						if (j <= i || SelfCollisionChains[j] == INDEX_NONE ||
+							SelfCollisionChains[i] == SelfCollisionChains[j] || Other.PhysicsSettings.Radius <= 0.0f ||
+							Bone.ParentIndex == Other.ParentIndex || Bone.ParentIndex == j || Other.ParentIndex == i)
+						{
+							continue;
+						}
+
+						const float LimitDistance = Bone.PhysicsSettings.Radius + Other.PhysicsSettings.Radius;
+						const FVector3f Delta = Other.Location - Bone.Location;
+						const float DistSquared = Delta.SizeSquared();
+						if (DistSquared >= LimitDistance * LimitDistance || DistSquared <= UE_SMALL_NUMBER)
+						{
+							continue;
+						}
+
+						// Push both bones apart, all of it on the simulated one if the other is not
+						const float Weight = Bone.bSkipSimulate ? 0.0f : 1.0f;
+						const float OtherWeight = Other.bSkipSimulate ? 0.0f : 1.0f;
+						if (Weight + OtherWeight <= 0.0f)
+						{
+							continue;
+						}
+						const float Dist = FMath::Sqrt(DistSquared);
+						const FVector3f Correction = Delta * ((LimitDistance - Dist) / (Dist * (Weight + OtherWeight)));
+						Bone.Location -= Correction * Weight;
+						Other.Location += Correction * OtherWeight;
+					}
+				}
 			}
-			Bone.Location += (LimitDistance - (Bone.Location - Sphere.Location).Size())
-				* (Bone.Location - Sphere.Location).GetSafeNormal();
 		}
-		else
+	}
+}
+
+void FAnimNode_KawaiiPhysics::AdjustSegmentBySphereCollision(FKawaiiPhysicsModifyBone& Bone,
+                                                             FKawaiiPhysicsModifyBone& ParentBone,
+                                                             const TArray<FSphericalLimit>& Limits)
+{
+	for (const auto& Sphere : Limits)
+	{
+		if (Sphere.bEnable && Sphere.Radius > 0.0f)
 		{
-			if ((Bone.Location - Sphere.Location).SizeSquared() < LimitDistance * LimitDistance)
-			{
-				continue;
-			}
-			Bone.Location = Sphere.Location + (Sphere.Radius - Bone.PhysicsSettings.Radius) * (Bone.Location - Sphere.
-				Location).GetSafeNormal();
+			KawaiiPhysics::AdjustSegmentBySphere(Bone, ParentBone, Sphere.Location, Sphere.Radius);
+		}
+	}
+}
+
+void FAnimNode_KawaiiPhysics::AdjustSegmentBySphereCollision(FKawaiiPhysicsModifyBone& Bone,
+                                                             FKawaiiPhysicsModifyBone& ParentBone,
+                                                             TConstArrayView<FSphericalLimit> Definitions,
+                                                             TConstArrayView<FKawaiiPhysicsLimitInstance> Instances)
+{
+	for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
+	{
+		if (Instances[i].bEnable && Definitions[i].Radius > 0.0f)
+		{
+			KawaiiPhysics::AdjustSegmentBySphere(Bone, ParentBone, Instances[i].Location, Definitions[i].Radius);
+		}
+	}
+}
+
+void FAnimNode_KawaiiPhysics::AdjustSegmentByCapsuleCollision(FKawaiiPhysicsModifyBone& Bone,
+                                                              FKawaiiPhysicsModifyBone& ParentBone,
+                                                              const TArray<FCapsuleLimit>& Limits)
+{
+	for (const auto& Capsule : Limits)
+	{
+		if (Capsule.bEnable && Capsule.Radius > 0 && Capsule.Length > 0)
+		{
+			KawaiiPhysics::AdjustSegmentByCapsule(Bone, ParentBone, Capsule.StartPoint, Capsule.EndPoint,
+			                                      Capsule.Radius);
+		}
+	}
+}
+
+void FAnimNode_KawaiiPhysics::AdjustSegmentByCapsuleCollision(FKawaiiPhysicsModifyBone& Bone,
+                                                              FKawaiiPhysicsModifyBone& ParentBone,
+                                                              TConstArrayView<FCapsuleLimit> Definitions,
+                                                              TConstArrayView<FKawaiiPhysicsLimitInstance> Instances)
+{
+	for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
+	{
+		const FCapsuleLimit& Capsule = Definitions[i];
+		const FKawaiiPhysicsLimitInstance& Instance = Instances[i];
+		if (Instance.bEnable && Capsule.Radius > 0 && Capsule.Length > 0)
+		{
+			KawaiiPhysics::AdjustSegmentByCapsule(Bone, ParentBone, Instance.StartPoint, Instance.EndPoint,
+			                                      Capsule.Radius);
+		}
+	}
+}
+
+void FAnimNode_KawaiiPhysics::AdjustBySphereCollision(FKawaiiPhysicsModifyBone& Bone, TArray<FSphericalLimit>& Limits)
+{
+	for (auto& Sphere : Limits)
+	{
+		if (Sphere.bEnable && Sphere.Radius > 0.0f)
+		{
+			KawaiiPhysics::AdjustBySphere(Bone, Sphere.Location, Sphere.Radius, Sphere.LimitType);
+		}
+	}
+}
+
+void FAnimNode_KawaiiPhysics::AdjustBySphereCollision(FKawaiiPhysicsModifyBone& Bone,
+                                                      TConstArrayView<FSphericalLimit> Definitions,
+                                                      TConstArrayView<FKawaiiPhysicsLimitInstance> Instances)
+{
+	for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
+	{
+		const FSphericalLimit& Sphere = Definitions[i];
+		if (Instances[i].bEnable && Sphere.Radius > 0.0f)
+		{
+			KawaiiPhysics::AdjustBySphere(Bone, Instances[i].Location, Sphere.Radius, Sphere.LimitType);
 		}
 	}
 }
@@ -1096,20 +1972,24 @@ void FAnimNode_KawaiiPhysics::AdjustByCapsuleCollision(FKawaiiPhysicsModifyBone&
 {
 	for (auto& Capsule : Limits)
 	{
-		if (!Capsule.bEnable || Capsule.Radius <= 0 || Capsule.Length <= 0)
+		if (Capsule.bEnable && Capsule.Radius > 0 && Capsule.Length > 0)
 		{
-			continue;
+			KawaiiPhysics::AdjustByCapsule(Bone, Capsule.StartPoint, Capsule.EndPoint, Capsule.Radius);
 		}
+	}
+}
 
-		FVector StartPoint = Capsule.Location + Capsule.Rotation.GetAxisZ() * Capsule.Length * 0.5f;
-		FVector EndPoint = Capsule.Location + Capsule.Rotation.GetAxisZ() * Capsule.Length * -0.5f;
-		const float DistSquared = FMath::PointDistToSegmentSquared(Bone.Location, StartPoint, EndPoint);
-
-		const float LimitDistance = Bone.PhysicsSettings.Radius + Capsule.Radius;
-		if (DistSquared < LimitDistance * LimitDistance)
+void FAnimNode_KawaiiPhysics::AdjustByCapsuleCollision(FKawaiiPhysicsModifyBone& Bone,
+                                                       TConstArrayView<FCapsuleLimit> Definitions,
+                                                       TConstArrayView<FKawaiiPhysicsLimitInstance> Instances)
+{
+	for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); ++i)
+	{
+		const FCapsuleLimit& Capsule = Definitions[i];
+		const FKawaiiPhysicsLimitInstance& Instance = Instances[i];
+		if (Instance.bEnable && Capsule.Radius > 0 && Capsule.Length > 0)
 		{
-			FVector ClosestPoint = FMath::ClosestPointOnSegment(Bone.Location, StartPoint, EndPoint);
-			Bone.Location = ClosestPoint + (Bone.Location - ClosestPoint).GetSafeNormal() * LimitDistance;
+			KawaiiPhysics::AdjustByCapsule(Bone, Instance.StartPoint, Instance.EndPoint, Capsule.Radius);
 		}
 	}
 }
@@ -1118,19 +1998,21 @@ void FAnimNode_KawaiiPhysics::AdjustByPlanerCollision(FKawaiiPhysicsModifyBone&
 {
 	for (auto& Planar : Limits)
 	{
-		if (!Planar.bEnable)
+		if (Planar.bEnable)
 		{
-			continue;
+			KawaiiPhysics::AdjustByPlane(Bone, Planar.Plane);
 		}
+	}
+}
 
-		FVector PointOnPlane = FVector::PointPlaneProject(Bone.Location, Planar.Plane);
-		const float DistSquared = (Bone.Location - PointOnPlane).SizeSquared();
-
-		FVector IntersectionPoint;
-		if (DistSquared < Bone.PhysicsSettings.Radius * Bone.PhysicsSettings.Radius ||
-			FMath::SegmentPlaneIntersection(Bone.Location, Bone.PrevLocation, Planar.Plane, IntersectionPoint))
+void FAnimNode_KawaiiPhysics::AdjustByPlanerCollision(FKawaiiPhysicsModifyBone& Bone,
+                                                      TConstArrayView<FKawaiiPhysicsLimitInstance> Instances)
+{
+	for (const FKawaiiPhysicsLimitInstance& Instance : Instances)
+	{
+		if (Instance.bEnable)
 		{
-			Bone.Location = PointOnPlane + Planar.Rotation.GetUpVector() * Bone.PhysicsSettings.Radius;
+			KawaiiPhysics::AdjustByPlane(Bone, Instance.Plane);
 		}
 	}
 }
@@ -1144,10 +2026,10 @@ void FAnimNode_KawaiiPhysics::AdjustByAngleLimit(
 		return;
 	}
 
-	FVector BoneDir = (Bone.Location - ParentBone.Location).GetSafeNormal();
-	const FVector PoseDir = (Bone.PoseLocation - ParentBone.PoseLocation).GetSafeNormal();
-	const FVector Axis = FVector::CrossProduct(PoseDir, BoneDir);
-	const float Angle = FMath::Atan2(Axis.Size(), FVector::DotProduct(PoseDir, BoneDir));
+	FVector3f BoneDir = (Bone.Location - ParentBone.Location).GetSafeNormal();
+	const FVector3f PoseDir = (GetPoseLocation(Bone.Index) - GetPoseLocation(ParentBone.Index)).GetSafeNormal();
+	const FVector3f Axis = FVector3f::CrossProduct(PoseDir, BoneDir);
+	const float Angle = FMath::Atan2(Axis.Size(), FVector3f::DotProduct(PoseDir, BoneDir));
 	const float AngleOverLimit = FMath::RadiansToDegrees(Angle) - Bone.PhysicsSettings.LimitAngle;
 
 	if (AngleOverLimit > 0.0f)
@@ -1162,23 +2044,24 @@ void FAnimNode_KawaiiPhysics::AdjustByPlanarConstraint(FKawaiiPhysicsModifyBone&
 {
 	if (PlanarConstraint != EPlanarConstraint::None)
 	{
-		FPlane Plane;
+		const FQuat4f ParentPoseRotation = GetPoseRotation(ParentBone.Index);
+		FPlane4f Plane;
 		switch (PlanarConstraint)
 		{
 		case EPlanarConstraint::X:
-			Plane = FPlane(ParentBone.Location, ParentBone.PoseRotation.GetAxisX());
+			Plane = FPlane4f(ParentBone.Location, ParentPoseRotation.GetAxisX());
 			break;
 		case EPlanarConstraint::Y:
-			Plane = FPlane(ParentBone.Location, ParentBone.PoseRotation.GetAxisY());
+			Plane = FPlane4f(ParentBone.Location, ParentPoseRotation.GetAxisY());
 			break;
 		case EPlanarConstraint::Z:
-			Plane = FPlane(ParentBone.Location, ParentBone.PoseRotation.GetAxisZ());
+			Plane = FPlane4f(ParentBone.Location, ParentPoseRotation.GetAxisZ());
 			break;
 		case EPlanarConstraint::None:
 			break;
 		default: ;
 		}
-		Bone.Location = FVector::PointPlaneProject(Bone.Location, Plane);
+		Bone.Location = FVector3f::PointPlaneProject(Bone.Location, Plane);
 	}
 }
 
@@ -1193,24 +2076,29 @@ const TArray<float> XPBDComplianceValues =
 	0.0001f, // 1.0  x 10^(-3) (M^2/N) Fat
 };
 
-void FAnimNode_KawaiiPhysics::AdjustByBoneConstraints()
+void FAnimNode_KawaiiPhysics::UpdateBoneConstraintCompliance()
 {
-	for (FModifyBoneConstraint& BoneConstraint : MergedBoneConstraints)
+	const float InvDeltaTimeSquared = 1.0f / FMath::Max(DeltaTime * DeltaTime, UE_SMALL_NUMBER);
+	const float GlobalCompliance = XPBDComplianceValues[static_cast<int32>(BoneConstraintGlobalComplianceType)];
+
+	for (FKawaiiPhysicsBoneConstraintRuntime& BoneConstraint : RuntimeBoneConstraints)
 	{
-		SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_AdjustByBoneConstraint);
+		const float Compliance = BoneConstraint.bGlobalCompliance ? GlobalCompliance : BoneConstraint.Compliance;
+		BoneConstraint.ScaledCompliance = Compliance * InvDeltaTimeSquared;
+		BoneConstraint.Lambda = 0.0f;
+	}
+}
 
-		if (!BoneConstraint.IsValid())
-		{
-			continue;
-		}
+void FAnimNode_KawaiiPhysics::AdjustByBoneConstraints()
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_AdjustByBoneConstraint);
 
+	for (FKawaiiPhysicsBoneConstraintRuntime& BoneConstraint : RuntimeBoneConstraints)
+	{
 		FKawaiiPhysicsModifyBone& ModifyBone1 = ModifyBones[BoneConstraint.ModifyBoneIndex1];
 		FKawaiiPhysicsModifyBone& ModifyBone2 = ModifyBones[BoneConstraint.ModifyBoneIndex2];
-		EXPBDComplianceType ComplianceType = BoneConstraint.bOverrideCompliance
-			                                     ? BoneConstraint.ComplianceType
-			                                     : BoneConstraintGlobalComplianceType;
 
-		FVector Delta = ModifyBone2.Location - ModifyBone1.Location;
+		FVector3f Delta = ModifyBone2.Location - ModifyBone1.Location;
 		float DeltaLength = Delta.Size();
 		if (DeltaLength <= 0.0f)
 		{
@@ -1223,9 +2111,8 @@ void FAnimNode_KawaiiPhysics::AdjustByBoneConstraints()
 		// ModifyBone2.Location -= Delta * Stiffness;
 
 		// XBPD
-		float Constraint = DeltaLength - BoneConstraint.Length;
-		float Compliance = XPBDComplianceValues[static_cast<int32>(ComplianceType)];
-		Compliance /= DeltaTime * DeltaTime;
+		const float Constraint = DeltaLength - BoneConstraint.Length;
+		const float Compliance = BoneConstraint.ScaledCompliance;
 		float DeltaLambda = (Constraint - Compliance * BoneConstraint.Lambda) / (2 + Compliance); // 2 = SumMass
 		Delta = (Delta / DeltaLength) * DeltaLambda;
 
@@ -1235,6 +2122,425 @@ void FAnimNode_KawaiiPhysics::AdjustByBoneConstraints()
 	}
 }
 
+namespace KawaiiPhysics
+{
+	// 2 : ScriptStruct name of each external force
+	// 3 : size of each external force state
+	constexpr uint8 StateVersion = 3;
+
+	int16 QuantizeSNorm(float Value)
+	{
+		return static_cast<int16>(FMath::Clamp(FMath::RoundToInt32(Value * MAX_int16), -MAX_int16, MAX_int16));
+	}
+
+	float DequantizeSNorm(int16 Value)
+	{
+		return Value / static_cast<float>(MAX_int16);
+	}
+
+	// Bytes of the bone block : bounds + 3 x (uint16, int16, int16) per bone, or Location, PrevLocation, PrevRotation
+	int64 GetBonesStateSize(int32 NumBones, bool bQuantized)
+	{
+		return bQuantized
+			       ? sizeof(FVector3f) * 2 + sizeof(float) + NumBones * 3 * (sizeof(uint16) + sizeof(int16) * 2)
+			       : NumBones * (sizeof(FVector3f) * 2 + sizeof(FQuat4f));
+	}
+}
+
+void FAnimNode_KawaiiPhysics::SaveState(TArray<uint8>& OutState, bool bQuantize) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_SaveState);
+
+	OutState.Reset();
+	FMemoryWriter Ar(OutState);
+
+	uint8 Version = KawaiiPhysics::StateVersion;
+	uint8 bQuantized = bQuantize ? 1 : 0;
+	int32 NumBones = ModifyBones.Num();
+	int32 NumForces = ExternalForces.Num();
+	float StateDeltaTimeOld = DeltaTimeOld;
+	FTransform StatePreSkelCompTransform = PreSkelCompTransform;
+	int32 Seed = RandomStream.GetCurrentSeed();
+	Ar << Version << bQuantized << NumBones << NumForces;
+	Ar << StateDeltaTimeOld << StatePreSkelCompTransform << Seed;
+
+	if (bQuantize)
+	{
+		// Location in the bounds of all bones, PrevLocation as an offset from Location, PrevRotation as XYZ with W >= 0
+		FVector3f BoundsMin(MAX_flt);
+		FVector3f BoundsMax(-MAX_flt);
+		float MaxOffset = 0.0f;
+		for (const FKawaiiPhysicsModifyBone& Bone : ModifyBones)
+		{
+			BoundsMin = FVector3f::Min(BoundsMin, Bone.Location);
+			BoundsMax = FVector3f::Max(BoundsMax, Bone.Location);
+			MaxOffset = FMath::Max(MaxOffset, (Bone.PrevLocation - Bone.Location).GetAbsMax());
+		}
+		FVector3f BoundsSize = NumBones > 0 ? BoundsMax - BoundsMin : FVector3f::ZeroVector;
+		Ar << BoundsMin << BoundsSize << MaxOffset;
+
+		for (const FKawaiiPhysicsModifyBone& Bone : ModifyBones)
+		{
+			const FVector3f PrevOffset = Bone.PrevLocation - Bone.Location;
+			const FQuat4f PrevRotation = Bone.PrevRotation.W < 0.0f ? -Bone.PrevRotation : Bone.PrevRotation;
+			int16 Rotation[3] = {
+				KawaiiPhysics::QuantizeSNorm(PrevRotation.X), KawaiiPhysics::QuantizeSNorm(PrevRotation.Y),
+				KawaiiPhysics::QuantizeSNorm(PrevRotation.Z)
+			};
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				const float Normalized = BoundsSize[Axis] > UE_SMALL_NUMBER
+					                         ? (Bone.Location[Axis] - BoundsMin[Axis]) / BoundsSize[Axis]
+					                         : 0.0f;
+				uint16 Location = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt32(Normalized * MAX_uint16), 0,
+				                                                   MAX_uint16));
+				int16 Offset = KawaiiPhysics::QuantizeSNorm(MaxOffset > 0.0f ? PrevOffset[Axis] / MaxOffset : 0.0f);
+				Ar << Location << Offset << Rotation[Axis];
+			}
+		}
+	}
+	else
+	{
+		for (const FKawaiiPhysicsModifyBone& Bone : ModifyBones)
+		{
+			FVector3f Location = Bone.Location;
+			FVector3f PrevLocation = Bone.PrevLocation;
+			FQuat4f PrevRotation = Bone.PrevRotation;
+			Ar << Location << PrevLocation << PrevRotation;
+		}
+	}
+
+	// The struct type and the size guard each force's own state, which it reads without knowing what was saved
+	for (const FInstancedStruct& Force : ExternalForces)
+	{
+		FName StructName = Force.GetScriptStruct() ? Force.GetScriptStruct()->GetFName() : NAME_None;
+		int32 StateSize = 0;
+		Ar << StructName;
+		const int64 StateSizeOffset = Ar.Tell();
+		Ar << StateSize;
+		if (Force.IsValid())
+		{
+			Force.Get<FKawaiiPhysics_ExternalForce>().SaveState(Ar);
+		}
+		const int64 StateEndOffset = Ar.Tell();
+		StateSize = static_cast<int32>(StateEndOffset - StateSizeOffset - sizeof(int32));
+		Ar.Seek(StateSizeOffset);
+		Ar << StateSize;
+		Ar.Seek(StateEndOffset);
+	}
+}
+
+bool FAnimNode_KawaiiPhysics::RestoreState(const TArray<uint8>& State)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_RestoreState);
+
+	FMemoryReader Ar(State);
+
+	// Saved from another setup : keep the current state
+	uint8 Version = 0;
+	uint8 bQuantized = 0;
+	int32 NumBones = 0;
+	int32 NumForces = 0;
+	Ar << Version << bQuantized << NumBones << NumForces;
+	if (Ar.IsError() || Version != KawaiiPhysics::StateVersion || NumBones != ModifyBones.Num() ||
+		NumForces != ExternalForces.Num())
+	{
+		return false;
+	}
+
+	float StateDeltaTimeOld = 0.0f;
+	FTransform StatePreSkelCompTransform;
+	int32 Seed = 0;
+	Ar << StateDeltaTimeOld << StatePreSkelCompTransform << Seed;
+	if (Ar.IsError() || Ar.TotalSize() - Ar.Tell() < KawaiiPhysics::GetBonesStateSize(NumBones, bQuantized != 0))
+	{
+		return false;
+	}
+
+	// Decoded into the scratch buffers and the force states only checked : a truncated or corrupted state
+	// leaves the node untouched
+	ReadBonesState(Ar, bQuantized != 0);
+	const int64 ForcesStateOffset = Ar.Tell();
+	if (!ValidateForcesState(Ar) || Ar.IsError() || !Ar.AtEnd())
+	{
+		return false;
+	}
+
+	for (int32 i = 0; i < ModifyBones.Num(); ++i)
+	{
+		ModifyBones[i].Location = StateScratchLocations[i];
+		ModifyBones[i].PrevLocation = StateScratchPrevLocations[i];
+		ModifyBones[i].PrevRotation = StateScratchPrevRotations[i];
+	}
+
+	Ar.Seek(ForcesStateOffset);
+	for (FInstancedStruct& Force : ExternalForces)
+	{
+		FName StructName;
+		int32 StateSize = 0;
+		Ar << StructName << StateSize;
+		if (Force.IsValid())
+		{
+			Force.GetMutable<FKawaiiPhysics_ExternalForce>().LoadState(Ar);
+		}
+	}
+
+	DeltaTimeOld = StateDeltaTimeOld;
+	PreSkelCompTransform = StatePreSkelCompTransform;
+	RandomStream.Initialize(Seed);
+	return true;
+}
+
+void FAnimNode_KawaiiPhysics::ReadBonesState(FArchive& Ar, bool bQuantized)
+{
+	const int32 NumBones = ModifyBones.Num();
+	StateScratchLocations.SetNumUninitialized(NumBones, false);
+	StateScratchPrevLocations.SetNumUninitialized(NumBones, false);
+	StateScratchPrevRotations.SetNumUninitialized(NumBones, false);
+
+	if (bQuantized)
+	{
+		FVector3f BoundsMin;
+		FVector3f BoundsSize;
+		float MaxOffset = 0.0f;
+		Ar << BoundsMin << BoundsSize << MaxOffset;
+
+		for (int32 i = 0; i < NumBones; ++i)
+		{
+			FVector3f& Location = StateScratchLocations[i];
+			FVector3f& PrevLocation = StateScratchPrevLocations[i];
+			float Rotation[3];
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				uint16 QuantizedLocation = 0;
+				int16 Offset = 0;
+				int16 QuantizedRotation = 0;
+				Ar << QuantizedLocation << Offset << QuantizedRotation;
+				Location[Axis] = BoundsMin[Axis] + QuantizedLocation * BoundsSize[Axis] / MAX_uint16;
+				PrevLocation[Axis] = Location[Axis] + KawaiiPhysics::DequantizeSNorm(Offset) * MaxOffset;
+				Rotation[Axis] = KawaiiPhysics::DequantizeSNorm(QuantizedRotation);
+			}
+			const float W = FMath::Sqrt(
+				FMath::Max(1.0f - Rotation[0] * Rotation[0] - Rotation[1] * Rotation[1] - Rotation[2] * Rotation[2],
+				           0.0f));
+			StateScratchPrevRotations[i] = FQuat4f(Rotation[0], Rotation[1], Rotation[2], W).GetNormalized();
+		}
+	}
+	else
+	{
+		for (int32 i = 0; i < NumBones; ++i)
+		{
+			Ar << StateScratchLocations[i] << StateScratchPrevLocations[i] << StateScratchPrevRotations[i];
+		}
+	}
+}
+
+bool FAnimNode_KawaiiPhysics::ValidateForcesState(FArchive& Ar)
+{
+	for (const FInstancedStruct& Force : ExternalForces)
+	{
+		FName StructName;
+		int32 StateSize = 0;
+		Ar << StructName << StateSize;
+		if (Ar.IsError() || StructName != (Force.GetScriptStruct() ? Force.GetScriptStruct()->GetFName() : NAME_None))
+		{
+			return false;
+		}
+
+		// Force states have a fixed size : measure it on the current state
+		StateScratchForceState.Reset();
+		if (Force.IsValid())
+		{
+			FMemoryWriter Writer(StateScratchForceState);
+			Force.Get<FKawaiiPhysics_ExternalForce>().SaveState(Writer);
+		}
+		if (StateSize != StateScratchForceState.Num() || Ar.TotalSize() - Ar.Tell() < StateSize)
+		{
+			return false;
+		}
+		Ar.Seek(Ar.Tell() + StateSize);
+	}
+	return true;
+}
+
+void FAnimNode_KawaiiPhysics::GetMemoryUsage(FKawaiiPhysicsMemoryUsage& OutUsage) const
+{
+	OutUsage.Bones = ModifyBones.GetAllocatedSize() + ModifyBoneChildIndices.GetAllocatedSize()
+		+ ModifyBoneRefs.GetAllocatedSize() + SelfCollisionChains.GetAllocatedSize()
+		+ OutputBoneOrder.GetAllocatedSize() + OutputCompactPoseIndices.GetAllocatedSize() + OutputBoneSlots.GetAllocatedSize()
+		+ ExcludeBones.GetAllocatedSize() + IgnoreBones.GetAllocatedSize() + IgnoreBoneNamePrefix.GetAllocatedSize();
+	OutUsage.PoseCache = BoneTransformsCS.GetAllocatedSize() + PoseGatherIndices.GetAllocatedSize();
+	OutUsage.Colliders = SphericalLimits.GetAllocatedSize() + CapsuleLimits.GetAllocatedSize()
+		+ PlanarLimits.GetAllocatedSize() + SphericalLimitsDataInstances.GetAllocatedSize()
+		+ CapsuleLimitsDataInstances.GetAllocatedSize() + PlanarLimitsDataInstances.GetAllocatedSize()
+		+ SphericalLimitsPhysicsAsset.GetAllocatedSize() + CapsuleLimitsPhysicsAsset.GetAllocatedSize();
+	OutUsage.Constraints = BoneConstraints.GetAllocatedSize() + MergedBoneConstraints.GetAllocatedSize()
+		+ RuntimeBoneConstraints.GetAllocatedSize();
+#if WITH_EDITORONLY_DATA
+	OutUsage.Constraints += BoneConstraintsData.GetAllocatedSize();
+#endif
+	OutUsage.ExternalForces = ExternalForces.GetAllocatedSize() + CustomExternalForces.GetAllocatedSize();
+	for (const FInstancedStruct& Force : ExternalForces)
+	{
+		if (const UScriptStruct* ScriptStruct = Force.GetScriptStruct())
+		{
+			OutUsage.ExternalForces += ScriptStruct->GetStructureSize();
+		}
+	}
+	OutUsage.Scratch = SelfCollisionCellStarts.GetAllocatedSize() + SelfCollisionSortedBones.GetAllocatedSize()
+		+ SelfCollisionBoneCells.GetAllocatedSize() + StateScratchLocations.GetAllocatedSize()
+		+ StateScratchPrevLocations.GetAllocatedSize() + StateScratchPrevRotations.GetAllocatedSize()
+		+ StateScratchForceState.GetAllocatedSize();
+
+	OutUsage.SharedColliders = SharedColliders.Get();
+	OutUsage.SharedCollidersSize = SharedColliders ? SharedColliders->GetAllocatedSize() : 0;
+}
+
+#if !UE_BUILD_SHIPPING
+namespace KawaiiPhysics
+{
+	// Reads the nodes of every AnimInstance from the game thread : run it while animations are not evaluating
+	void MemReport(FOutputDevice& Ar)
+	{
+		FKawaiiPhysicsMemoryUsage Total;
+		TSet<const void*> SharedColliderSets;
+		SIZE_T SharedCollidersSize = 0;
+		int32 NumNodes = 0;
+		int32 NumBones = 0;
+
+		Ar.Logf(TEXT("KawaiiPhysics memory (bytes) : Bones / PoseCache / Colliders / Constraints / ExternalForces / Scratch"));
+		for (TObjectIterator<UAnimInstance> It; It; ++It)
+		{
+			const UAnimInstance* AnimInstance = *It;
+			const IAnimClassInterface* AnimClass = IAnimClassInterface::GetFromClass(AnimInstance->GetClass());
+			if (!AnimClass || AnimInstance->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+			{
+				continue;
+			}
+
+			for (const FStructProperty* Property : AnimClass->GetAnimNodeProperties())
+			{
+				if (!Property->Struct->IsChildOf(FAnimNode_KawaiiPhysics::StaticStruct()))
+				{
+					continue;
+				}
+
+				const FAnimNode_KawaiiPhysics& Node = *Property->ContainerPtrToValuePtr<FAnimNode_KawaiiPhysics>(
+					AnimInstance);
+				FKawaiiPhysicsMemoryUsage Usage;
+				Node.GetMemoryUsage(Usage);
+
+				const int32 NodeBones = Node.ModifyBones.Num();
+				Ar.Logf(TEXT("%s %s (%s) : %d bones, %llu bytes (%.1f per bone) : %llu / %llu / %llu / %llu / %llu / %llu"),
+				        *GetNameSafe(AnimInstance->GetOwningActor()), *AnimInstance->GetClass()->GetName(),
+				        *Node.RootBone.BoneName.ToString(), NodeBones, static_cast<uint64>(Usage.GetTotal()),
+				        NodeBones > 0 ? static_cast<double>(Usage.GetTotal()) / NodeBones : 0.0,
+				        static_cast<uint64>(Usage.Bones), static_cast<uint64>(Usage.PoseCache),
+				        static_cast<uint64>(Usage.Colliders), static_cast<uint64>(Usage.Constraints),
+				        static_cast<uint64>(Usage.ExternalForces), static_cast<uint64>(Usage.Scratch));
+
+				NumNodes++;
+				NumBones += NodeBones;
+				Total.Bones += Usage.Bones;
+				Total.PoseCache += Usage.PoseCache;
+				Total.Colliders += Usage.Colliders;
+				Total.Constraints += Usage.Constraints;
+				Total.ExternalForces += Usage.ExternalForces;
+				Total.Scratch += Usage.Scratch;
+				if (Usage.SharedColliders && !SharedColliderSets.Contains(Usage.SharedColliders))
+				{
+					SharedColliderSets.Add(Usage.SharedColliders);
+					SharedCollidersSize += Usage.SharedCollidersSize;
+				}
+			}
+		}
+
+		Ar.Logf(TEXT("Total : %d nodes, %d bones, %llu bytes (%.1f per bone) : %llu / %llu / %llu / %llu / %llu / %llu"),
+		        NumNodes, NumBones, static_cast<uint64>(Total.GetTotal()),
+		        NumBones > 0 ? static_cast<double>(Total.GetTotal()) / NumBones : 0.0,
+		        static_cast<uint64>(Total.Bones), static_cast<uint64>(Total.PoseCache),
+		        static_cast<uint64>(Total.Colliders), static_cast<uint64>(Total.Constraints),
+		        static_cast<uint64>(Total.ExternalForces), static_cast<uint64>(Total.Scratch));
+		Ar.Logf(TEXT("Shared colliders : %d sets, %llu bytes"), SharedColliderSets.Num(),
+		        static_cast<uint64>(SharedCollidersSize));
+		// Measured, not sizeof of the simulated fields : a bone also carries its pose, settings and gathered transform
+		Ar.Logf(TEXT("Per bone : %.1f bytes of bones, %.1f bytes of pose cache"),
+		        NumBones > 0 ? static_cast<double>(Total.Bones) / NumBones : 0.0,
+		        NumBones > 0 ? static_cast<double>(Total.PoseCache) / NumBones : 0.0);
+	}
+}
+
+static FAutoConsoleCommandWithOutputDevice KawaiiPhysicsMemReportCommand(
+	TEXT("a.AnimNode.KawaiiPhysics.MemReport"),
+	TEXT("List the heap memory of every KawaiiPhysics node by category"),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&KawaiiPhysics::MemReport));
+#endif
+
+bool FAnimNode_KawaiiPhysics::PlaybackSimulationCache()
+{
+	if (SimulationCacheMode != EKawaiiPhysicsSimulationCacheMode::Playback || !SimulationCache ||
+		!SimulationCache->IsValidFor(ModifyBones.Num()))
+	{
+		return false;
+	}
+
+	SimulationCache->SampleLocations(SimulationCacheTime, ModifyBones);
+	return true;
+}
+
+int32 FAnimNode_KawaiiPhysics::BeginSimulationCacheFrame()
+{
+	if (!SimulationCache->IsRecording())
+	{
+		SimulationCache->BeginRecording(ModifyBones.Num());
+		LastRecordedCacheFrame = INDEX_NONE;
+	}
+
+	// Started past the beginning or jumped back (scrubbing) : resume from the recorded state before this frame,
+	// and simulate every frame from there to this one
+	const int32 Frame = SimulationCache->GetFrameIndex(SimulationCacheTime);
+	if (Frame > 0 && (LastRecordedCacheFrame == INDEX_NONE || Frame < LastRecordedCacheFrame))
+	{
+		float KeyframeDeltaTime = 0.0f;
+		const int32 KeyframeFrame = SimulationCache->RestoreKeyframe(Frame - 1, ModifyBones, KeyframeDeltaTime);
+		if (KeyframeFrame != INDEX_NONE)
+		{
+			if (KeyframeDeltaTime > 0.0f)
+			{
+				DeltaTimeOld = KeyframeDeltaTime;
+			}
+			return KeyframeFrame + 1;
+		}
+	}
+
+	// The cache frame is the simulation clock : nothing to step while it has not advanced (paused timeline or
+	// evaluation faster than FrameRate), and every frame skipped by a low update rate is stepped on its own
+	if (Frame == LastRecordedCacheFrame)
+	{
+		return INDEX_NONE;
+	}
+	return LastRecordedCacheFrame != INDEX_NONE && Frame > LastRecordedCacheFrame ? LastRecordedCacheFrame + 1 : Frame;
+}
+
+void FAnimNode_KawaiiPhysics::RecordSimulationCacheFrames(FComponentSpacePoseContext& Output,
+                                                          const FTransform& ComponentTransform, int32 FirstFrame)
+{
+	const int32 Frame = SimulationCache->GetFrameIndex(SimulationCacheTime);
+	const float EvaluationDeltaTime = DeltaTime;
+	DeltaTime = 1.0f / SimulationCache->FrameRate;
+	for (int32 RecordedFrame = FirstFrame; RecordedFrame <= Frame; ++RecordedFrame)
+	{
+		SimulateModifyBones(Output, ComponentTransform);
+		SimulationCache->RecordFrame(RecordedFrame, ModifyBones, DeltaTime);
+
+		// The component moved once in this evaluation, not once per step
+		SkelCompMoveVector = FVector3f::ZeroVector;
+		SkelCompMoveRotation = FQuat4f::Identity;
+	}
+	DeltaTime = EvaluationDeltaTime;
+	LastRecordedCacheFrame = Frame;
+}
+
 void FAnimNode_KawaiiPhysics::WarmUp(FComponentSpacePoseContext& Output, const FBoneContainer& BoneContainer,
                                      FTransform& ComponentTransform)
 {
@@ -1246,29 +2552,39 @@ void FAnimNode_KawaiiPhysics::WarmUp(FComponentSpacePoseContext& Output, const F
 	}
 }
 
-void FAnimNode_KawaiiPhysics::InitBoneConstraints()
+void FAnimNode_KawaiiPhysics::InitExternalForces()
+{
+	for (int i = 0; i < ExternalForces.Num(); ++i)
+	{
+		if (ExternalForces[i].IsValid())
+		{
+			ExternalForces[i].GetMutable<FKawaiiPhysics_ExternalForce>().InitBones(*this);
+		}
+	}
+}
+
+void FAnimNode_KawaiiPhysics::InitBoneConstraints(const FBoneContainer& BoneContainer)
 {
 	MergedBoneConstraints = BoneConstraints;
-	MergedBoneConstraints.Append(BoneConstraintsData);
+	if (BoneConstraintsDataAsset)
+	{
+		BoneConstraintsDataAsset->AppendBoneConstraints(MergedBoneConstraints);
+		for (int32 i = BoneConstraints.Num(); i < MergedBoneConstraints.Num(); ++i)
+		{
+			MergedBoneConstraints[i].InitializeBone(BoneContainer);
+		}
+	}
 
 	TArray<FModifyBoneConstraint> DummyBoneConstraint;
 	for (FModifyBoneConstraint& Constraint : MergedBoneConstraints)
 	{
-		Constraint.ModifyBoneIndex1 =
-			ModifyBones.IndexOfByPredicate([Constraint](const FKawaiiPhysicsModifyBone& ModifyBone)
-			{
-				return ModifyBone.BoneRef == Constraint.Bone1;
-			});
+		Constraint.ModifyBoneIndex1 = ModifyBoneRefs.IndexOfByKey(Constraint.Bone1);
 		if (Constraint.ModifyBoneIndex1 < 0)
 		{
 			continue;
 		}
 
-		Constraint.ModifyBoneIndex2 =
-			ModifyBones.IndexOfByPredicate([Constraint](const FKawaiiPhysicsModifyBone& ModifyBone)
-			{
-				return ModifyBone.BoneRef == Constraint.Bone2;
-			});
+		Constraint.ModifyBoneIndex2 = ModifyBoneRefs.IndexOfByKey(Constraint.Bone2);
 		if (Constraint.ModifyBoneIndex2 < 0)
 		{
 			continue;
@@ -1281,12 +2597,14 @@ void FAnimNode_KawaiiPhysics::InitBoneConstraints()
 		// DummyBone"s constraint
 		if (bAutoAddChildDummyBoneConstraint)
 		{
-			const int32 ChildDummyBoneIndex1 = ModifyBones[Constraint.ModifyBoneIndex1].ChildIndexs.IndexOfByPredicate(
+			const TConstArrayView<int32> ChildIndices1 = GetChildIndices(ModifyBones[Constraint.ModifyBoneIndex1]);
+			const TConstArrayView<int32> ChildIndices2 = GetChildIndices(ModifyBones[Constraint.ModifyBoneIndex2]);
+			const int32 ChildDummyBoneIndex1 = ChildIndices1.IndexOfByPredicate(
 				[&](int32 Index)
 				{
 					return Index >= 0 && ModifyBones[Index].bDummy == true;
 				});
-			const int32 ChildDummyBoneIndex2 = ModifyBones[Constraint.ModifyBoneIndex2].ChildIndexs.IndexOfByPredicate(
+			const int32 ChildDummyBoneIndex2 = ChildIndices2.IndexOfByPredicate(
 				[&](int32 Index)
 				{
 					return Index >= 0 && ModifyBones[Index].bDummy == true;
@@ -1295,10 +2613,8 @@ void FAnimNode_KawaiiPhysics::InitBoneConstraints()
 			if (ChildDummyBoneIndex1 >= 0 && ChildDummyBoneIndex2 >= 0)
 			{
 				FModifyBoneConstraint NewDummyBoneConstraint;
-				NewDummyBoneConstraint.ModifyBoneIndex1 = ModifyBones[Constraint.ModifyBoneIndex1].ChildIndexs[
-					ChildDummyBoneIndex1];
-				NewDummyBoneConstraint.ModifyBoneIndex2 = ModifyBones[Constraint.ModifyBoneIndex2].ChildIndexs[
-					ChildDummyBoneIndex2];
+				NewDummyBoneConstraint.ModifyBoneIndex1 = ChildIndices1[ChildDummyBoneIndex1];
+				NewDummyBoneConstraint.ModifyBoneIndex2 = ChildIndices2[ChildDummyBoneIndex2];
 				NewDummyBoneConstraint.Length =
 					(ModifyBones[NewDummyBoneConstraint.ModifyBoneIndex1].Location - ModifyBones[NewDummyBoneConstraint.
 						ModifyBoneIndex2].Location).
@@ -1310,17 +2626,68 @@ void FAnimNode_KawaiiPhysics::InitBoneConstraints()
 	}
 
 	MergedBoneConstraints.Append(DummyBoneConstraint);
+
+	RuntimeBoneConstraints.Reset(MergedBoneConstraints.Num());
+	for (const FModifyBoneConstraint& Constraint : MergedBoneConstraints)
+	{
+		if (!Constraint.IsValid() || !Constraint.IsBoneReferenceValid())
+		{
+			continue;
+		}
+
+		FKawaiiPhysicsBoneConstraintRuntime& RuntimeConstraint = RuntimeBoneConstraints.AddDefaulted_GetRef();
+		RuntimeConstraint.ModifyBoneIndex1 = Constraint.ModifyBoneIndex1;
+		RuntimeConstraint.ModifyBoneIndex2 = Constraint.ModifyBoneIndex2;
+		RuntimeConstraint.Length = Constraint.Length;
+		// Dummy constraints never override and follow the global type
+		RuntimeConstraint.bGlobalCompliance = !Constraint.bOverrideCompliance;
+		RuntimeConstraint.Compliance = XPBDComplianceValues[static_cast<int32>(Constraint.ComplianceType)];
+	}
+}
+
+void FAnimNode_KawaiiPhysics::InitOutputBoneOrder(const FBoneContainer& BoneContainer)
+{
+	OutputBoneOrder.Reset(ModifyBones.Num());
+	OutputBoneSlots.Init(INDEX_NONE, ModifyBones.Num());
+	for (int32 i = 0; i < ModifyBones.Num(); ++i)
+	{
+		if (ModifyBoneRefs[i].GetCompactPoseIndex(BoneContainer).IsValid())
+		{
+			OutputBoneOrder.Add(i);
+		}
+	}
+
+	// for check in FCSPose<PoseType>::LocalBlendCSBoneTransforms
+	OutputBoneOrder.Sort([this, &BoneContainer](int32 A, int32 B)
+	{
+		return ModifyBoneRefs[A].GetCompactPoseIndex(BoneContainer) <
+			ModifyBoneRefs[B].GetCompactPoseIndex(BoneContainer);
+	});
+
+	OutputCompactPoseIndices.Reset(OutputBoneOrder.Num());
+	for (int32 Slot = 0; Slot < OutputBoneOrder.Num(); ++Slot)
+	{
+		OutputCompactPoseIndices.Add(ModifyBoneRefs[OutputBoneOrder[Slot]].GetCompactPoseIndex(BoneContainer));
+		OutputBoneSlots[OutputBoneOrder[Slot]] = Slot;
+	}
+
+	OutputBoneContainerSerial = BoneContainer.GetSerialNumber();
 }
 
 void FAnimNode_KawaiiPhysics::ApplySimulateResult(FComponentSpacePoseContext& Output,
                                                   const FBoneContainer& BoneContainer,
                                                   TArray<FBoneTransform>& OutBoneTransforms)
 {
-	for (int32 i = 0; i < ModifyBones.Num(); ++i)
+	if (OutputBoneSlots.Num() != ModifyBones.Num() || OutputBoneContainerSerial != BoneContainer.GetSerialNumber())
+	{
+		InitOutputBoneOrder(BoneContainer);
+	}
+
+	// Already in compact pose order, so no RemoveAll/Sort is needed afterwards
+	OutBoneTransforms.Reserve(OutputBoneOrder.Num());
+	for (int32 Slot = 0; Slot < OutputBoneOrder.Num(); ++Slot)
 	{
-		OutBoneTransforms.Add(FBoneTransform(ModifyBones[i].BoneRef.GetCompactPoseIndex(BoneContainer),
-		                                     FTransform(ModifyBones[i].PoseRotation, ModifyBones[i].PoseLocation,
-		                                                ModifyBones[i].PoseScale)));
+		OutBoneTransforms.Emplace(OutputCompactPoseIndices[Slot], BoneTransformsCS[OutputBoneOrder[Slot]]);
 	}
 
 	for (int32 i = 1; i < ModifyBones.Num(); ++i)
@@ -1328,12 +2695,13 @@ void FAnimNode_KawaiiPhysics::ApplySimulateResult(FComponentSpacePoseContext& Ou
 		FKawaiiPhysicsModifyBone& Bone = ModifyBones[i];
 		FKawaiiPhysicsModifyBone& ParentBone = ModifyBones[Bone.ParentIndex];
 
-		if (ParentBone.ChildIndexs.Num() <= 1)
+		if (ParentBone.NumChildren <= 1)
 		{
-			if (ParentBone.BoneRef.BoneIndex >= 0)
+			if (ModifyBoneRefs[Bone.ParentIndex].BoneIndex >= 0)
 			{
-				FVector PoseVector = Bone.PoseLocation - ParentBone.PoseLocation;
-				FVector SimulateVector = Bone.Location - ParentBone.Location;
+				const FQuat4f ParentPoseRotation = GetPoseRotation(Bone.ParentIndex);
+				FVector3f PoseVector = GetPoseLocation(i) - GetPoseLocation(Bone.ParentIndex);
+				FVector3f SimulateVector = Bone.Location - ParentBone.Location;
 
 				if (PoseVector.GetSafeNormal() == SimulateVector.GetSafeNormal())
 				{
@@ -1347,24 +2715,19 @@ void FAnimNode_KawaiiPhysics::ApplySimulateResult(FComponentSpacePoseContext& Ou
 					SimulateVector *= -1;
 				}
 
-				FQuat SimulateRotation = FQuat::FindBetweenVectors(PoseVector, SimulateVector) * ParentBone.
-					PoseRotation;
-				OutBoneTransforms[Bone.ParentIndex].Transform.SetRotation(SimulateRotation);
+				FQuat4f SimulateRotation =
+					FQuat4f::FindBetweenVectors(PoseVector, SimulateVector) * ParentPoseRotation;
+				if (const int32 ParentSlot = OutputBoneSlots[Bone.ParentIndex]; ParentSlot != INDEX_NONE)
+				{
+					OutBoneTransforms[ParentSlot].Transform.SetRotation(FQuat(SimulateRotation));
+				}
 				ParentBone.PrevRotation = SimulateRotation;
 			}
 		}
 
-		if (Bone.BoneRef.BoneIndex >= 0 && !Bone.bDummy)
+		if (!Bone.bDummy && ModifyBoneRefs[i].BoneIndex >= 0 && OutputBoneSlots[i] != INDEX_NONE)
 		{
-			OutBoneTransforms[i].Transform.SetLocation(Bone.Location);
+			OutBoneTransforms[OutputBoneSlots[i]].Transform.SetLocation(FVector(Bone.Location));
 		}
 	}
-
-	OutBoneTransforms.RemoveAll([](const FBoneTransform& BoneTransform)
-	{
-		return BoneTransform.BoneIndex < 0;
-	});
-
-	// for check in FCSPose<PoseType>::LocalBlendCSBoneTransforms
-	OutBoneTransforms.Sort(FCompareBoneTransformIndex());
 }
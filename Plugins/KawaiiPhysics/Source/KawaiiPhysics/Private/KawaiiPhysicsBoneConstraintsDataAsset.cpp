@@ -36,19 +36,23 @@ FCustomVersionRegistration GRegisterBoneConstraintDataCustomVersion(FBoneConstra
 TArray<FModifyBoneConstraint> UKawaiiPhysicsBoneConstraintsDataAsset::GenerateBoneConstraints()
 {
 	TArray<FModifyBoneConstraint> BoneConstraints;
+	AppendBoneConstraints(BoneConstraints);
 
-	for (const FModifyBoneConstraintData BoneConstraintData : BoneConstraintsData)
+	return BoneConstraints;
+}
+
+void UKawaiiPhysicsBoneConstraintsDataAsset::AppendBoneConstraints(
+	TArray<FModifyBoneConstraint>& OutBoneConstraints) const
+{
+	OutBoneConstraints.Reserve(OutBoneConstraints.Num() + BoneConstraintsData.Num());
+	for (const FModifyBoneConstraintData& BoneConstraintData : BoneConstraintsData)
 	{
-		FModifyBoneConstraint BoneConstraint;
+		FModifyBoneConstraint& BoneConstraint = OutBoneConstraints.AddDefaulted_GetRef();
 		BoneConstraint.Bone1 = BoneConstraintData.BoneReference1;
 		BoneConstraint.Bone2 = BoneConstraintData.BoneReference2;
 		BoneConstraint.bOverrideCompliance = BoneConstraintData.bOverrideCompliance;
 		BoneConstraint.ComplianceType = BoneConstraintData.ComplianceType;
-
-		BoneConstraints.Add(BoneConstraint);
 	}
-
-	return BoneConstraints;
 }
 
 void UKawaiiPhysicsBoneConstraintsDataAsset::Serialize(FStructuredArchiveRecord Record)
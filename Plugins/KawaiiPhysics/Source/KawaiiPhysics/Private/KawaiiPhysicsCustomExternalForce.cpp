@@ -1 +1,81 @@
 ﻿#include "KawaiiPhysicsCustomExternalForce.h"
+
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_CustomExternalForce_PreUpdate"), STAT_KawaiiPhysics_CustomExternalForce_PreUpdate,
+                   STATGROUP_Anim);
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_CustomExternalForce_ApplyBatch"), STAT_KawaiiPhysics_CustomExternalForce_ApplyBatch,
+                   STATGROUP_Anim);
+
+void UKawaiiPhysics_CustomExternalForce::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// A C++ override can only be told apart by calling it : the default Apply_Implementation reports itself
+	// on the first ApplyBatch
+	bImplementsBlueprintApply = GetClass()->IsFunctionImplementedInScript(
+		GET_FUNCTION_NAME_CHECKED(UKawaiiPhysics_CustomExternalForce, Apply));
+}
+
+void UKawaiiPhysics_CustomExternalForce::PreUpdate(FAnimNode_KawaiiPhysics& Node,
+                                                   const USkeletalMeshComponent* SkelComp)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_CustomExternalForce_PreUpdate);
+
+	PreApply(Node, SkelComp);
+	PreUpdateSkelComp = SkelComp;
+
+	ForceCS = ConstantForce;
+	if (ExternalForceSpace == EExternalForceSpace::WorldSpace && SkelComp)
+	{
+		ForceCS = SkelComp->GetComponentTransform().InverseTransformVector(ConstantForce);
+	}
+}
+
+void UKawaiiPhysics_CustomExternalForce::ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones,
+                                                    FAnimNode_KawaiiPhysics& Node,
+                                                    const FComponentSpacePoseContext& PoseContext,
+                                                    TConstArrayView<FTransform> BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_CustomExternalForce_ApplyBatch);
+
+	if (!ForceCS.IsNearlyZero())
+	{
+		const bool bBoneSpace = ExternalForceSpace == EExternalForceSpace::BoneSpace;
+		for (FKawaiiPhysicsModifyBone& Bone : Bones)
+		{
+			if (Bone.bSkipSimulate)
+			{
+				continue;
+			}
+
+			const FVector3f BoneForce(bBoneSpace ? BoneTransforms[Bone.Index].TransformVector(ForceCS) : ForceCS);
+			Bone.Location += BoneForce * Node.DeltaTime;
+		}
+	}
+
+	// Legacy per bone Apply, skipped entirely unless a subclass implements it
+	if (!bImplementsBlueprintApply && !bImplementsNativeApply)
+	{
+		return;
+	}
+	const USkeletalMeshComponent* SkelComp = PreUpdateSkelComp;
+	for (FKawaiiPhysicsModifyBone& Bone : Bones)
+	{
+		if (Bone.bSkipSimulate)
+		{
+			continue;
+		}
+
+		if (bImplementsBlueprintApply)
+		{
+			Apply(Node, Bone.Index, SkelComp, BoneTransforms[Bone.Index]);
+		}
+		else
+		{
+			Apply_Implementation(Node, Bone.Index, SkelComp, BoneTransforms[Bone.Index]);
+			if (!bImplementsNativeApply)
+			{
+				return;
+			}
+		}
+	}
+}
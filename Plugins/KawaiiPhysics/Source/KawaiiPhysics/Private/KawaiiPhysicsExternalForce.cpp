@@ -1,8 +1,5 @@
 ﻿#include "KawaiiPhysicsExternalForce.h"
 
-#include "GameFramework/Character.h"
-#include "GameFramework/CharacterMovementComponent.h"
-
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_ExternalForce_Basic_Apply"), STAT_KawaiiPhysics_ExternalForce_Basic_Apply,
                    STATGROUP_Anim);
 DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_ExternalForce_Gravity_Apply"), STAT_KawaiiPhysics_ExternalForce_Gravity_Apply,
@@ -13,6 +10,13 @@ DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_ExternalForce_Curve_Apply"), STAT_KawaiiP
 ///
 /// Basic
 ///
+void FKawaiiPhysics_ExternalForce_Basic::InitBones(const FAnimNode_KawaiiPhysics& Node)
+{
+	Super::InitBones(Node);
+
+	BakeForceRates(Node, ForceRateByBoneLengthRate);
+}
+
 void FKawaiiPhysics_ExternalForce_Basic::PreApply(FAnimNode_KawaiiPhysics& Node,
                                                   const USkeletalMeshComponent* SkelComp)
 {
@@ -22,7 +26,7 @@ void FKawaiiPhysics_ExternalForce_Basic::PreApply(FAnimNode_KawaiiPhysics& Node,
 	{
 		if (Time > Interval)
 		{
-			Force = ForceDir * FMath::RandRange(RandomForceScale.Min, RandomForceScale.Max);
+			Force = ForceDir * GetRandomForceScale(Node);
 			Time = FMath::Fmod(Time, Interval);
 		}
 		else
@@ -32,13 +36,12 @@ void FKawaiiPhysics_ExternalForce_Basic::PreApply(FAnimNode_KawaiiPhysics& Node,
 	}
 	else
 	{
-		Force = ForceDir * FMath::RandRange(RandomForceScale.Min, RandomForceScale.Max);
+		Force = ForceDir * GetRandomForceScale(Node);
 	}
 
 	if (ExternalForceSpace == EExternalForceSpace::WorldSpace)
 	{
-		const FTransform ComponentTransform = SkelComp->GetComponentTransform();
-		Force = ComponentTransform.InverseTransformVector(Force);
+		Force = Node.GetGameThreadInput().ComponentTransform.InverseTransformVector(Force);
 	}
 }
 
@@ -52,27 +55,62 @@ void FKawaiiPhysics_ExternalForce_Basic::Apply(FKawaiiPhysicsModifyBone& Bone, F
 
 	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_ExternalForce_Basic_Apply);
 
-	float ForceRate = 1.0f;
-	if (const auto Curve = ForceRateByBoneLengthRate.GetRichCurve(); !Curve->IsEmpty())
-	{
-		ForceRate = Curve->Eval(Bone.LengthFromRoot / Node.GetTotalBoneLength());
-	}
+	const float ForceRate = GetForceRate(Bone, Node, ForceRateByBoneLengthRate);
 
 	if (ExternalForceSpace == EExternalForceSpace::BoneSpace)
 	{
 		const FVector BoneForce = BoneTM.TransformVector(Force);
-		Bone.Location += BoneForce * ForceRate * Node.DeltaTime;
+		Bone.Location += FVector3f(BoneForce * ForceRate * Node.DeltaTime);
 
 #if ENABLE_ANIM_DEBUG
-		BoneForceMap.Add(Bone.BoneRef.BoneName, BoneForce);
+		if (ShouldRecordDebugForce())
+		{
+			RecordDebugForce(Node, Bone.Index, BoneForce);
+		}
 #endif
 	}
 	else
 	{
-		Bone.Location += Force * ForceRate * Node.DeltaTime;
+		Bone.Location += FVector3f(Force * ForceRate * Node.DeltaTime);
 
 #if ENABLE_ANIM_DEBUG
-		BoneForceMap.Add(Bone.BoneRef.BoneName, Force * ForceRate);
+		if (ShouldRecordDebugForce())
+		{
+			RecordDebugForce(Node, Bone.Index, Force * ForceRate);
+		}
+#endif
+	}
+}
+
+void FKawaiiPhysics_ExternalForce_Basic::ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones,
+                                                    FAnimNode_KawaiiPhysics& Node,
+                                                    const FComponentSpacePoseContext& PoseContext,
+                                                    TConstArrayView<FTransform> BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_ExternalForce_Basic_Apply);
+#if ENABLE_ANIM_DEBUG
+	const bool bRecordDebugForce = ShouldRecordDebugForce();
+#endif
+
+	const bool bBoneSpace = ExternalForceSpace == EExternalForceSpace::BoneSpace;
+	const FVector3f Force3f = FVector3f(Force);
+
+	for (FKawaiiPhysicsModifyBone& Bone : Bones)
+	{
+		if (Bone.bSkipSimulate || !CanApply(Bone))
+		{
+			continue;
+		}
+
+		const float ForceRate = GetForceRate(Bone, Node, ForceRateByBoneLengthRate);
+		const FVector3f BoneForce = bBoneSpace ? FVector3f(BoneTransforms[Bone.Index].TransformVector(Force)) : Force3f;
+		Bone.Location += BoneForce * ForceRate * Node.DeltaTime;
+
+#if ENABLE_ANIM_DEBUG
+		if (bRecordDebugForce)
+		{
+			RecordDebugForce(Node, Bone.Index, FVector(bBoneSpace ? BoneForce : BoneForce * ForceRate));
+		}
 #endif
 	}
 }
@@ -80,35 +118,38 @@ void FKawaiiPhysics_ExternalForce_Basic::Apply(FKawaiiPhysicsModifyBone& Bone, F
 ///
 /// Gravity
 ///
+void FKawaiiPhysics_ExternalForce_Gravity::InitBones(const FAnimNode_KawaiiPhysics& Node)
+{
+	Super::InitBones(Node);
+
+	BakeForceRates(Node, ForceRateByBoneLengthRate);
+}
+
 void FKawaiiPhysics_ExternalForce_Gravity::PreApply(FAnimNode_KawaiiPhysics& Node,
                                                     const USkeletalMeshComponent* SkelComp)
 {
 	Force = bUseOverrideGravityDirection ? OverrideGravityDirection : FVector(0, 0, -1.0f);
 
-	// For Character's Custom Gravity Direction
-	if (const ACharacter* Character = Cast<ACharacter>(SkelComp->GetOwner()))
+	// For Character's Custom Gravity Direction (captured in FAnimNode_KawaiiPhysics::PreUpdate)
+	const FKawaiiPhysicsGameThreadInput& Input = Node.GetGameThreadInput();
+	if (Input.bHasCharacter)
 	{
 #if	ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3
 		if (bUseCharacterGravityDirection)
 		{
-			Force = Character->GetGravityDirection();
+			Force = Input.CharacterGravityDirection;
 		}
 #endif
 
-		if (bUseCharacterGravityScale)
+		if (bUseCharacterGravityScale && Input.bHasCharacterMovement)
 		{
-			if (const UCharacterMovementComponent* CharacterMovementComponent = Character->
-				GetCharacterMovement())
-			{
-				Force *= CharacterMovementComponent->GetGravityZ();
-			}
+			Force *= Input.CharacterGravityZ;
 		}
 	}
 
-	Force *= FMath::RandRange(RandomForceScale.Min, RandomForceScale.Max);
+	Force *= GetRandomForceScale(Node);
 
-	const FTransform ComponentTransform = SkelComp->GetComponentTransform();
-	Force = ComponentTransform.InverseTransformVector(Force);
+	Force = Input.ComponentTransform.InverseTransformVector(Force);
 }
 
 void FKawaiiPhysics_ExternalForce_Gravity::Apply(FKawaiiPhysicsModifyBone& Bone, FAnimNode_KawaiiPhysics& Node,
@@ -122,18 +163,49 @@ void FKawaiiPhysics_ExternalForce_Gravity::Apply(FKawaiiPhysicsModifyBone& Bone,
 
 	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_ExternalForce_Gravity_Apply);
 
-	float ForceRate = 1.0f;
-	if (const auto Curve = ForceRateByBoneLengthRate.GetRichCurve(); !Curve->IsEmpty())
+	const float ForceRate = GetForceRate(Bone, Node, ForceRateByBoneLengthRate);
+
+	Bone.Location += FVector3f(0.5f * Force * ForceRate * Node.DeltaTime * Node.DeltaTime);
+
+#if ENABLE_ANIM_DEBUG
+	if (ShouldRecordDebugForce())
 	{
-		ForceRate = Curve->Eval(Bone.LengthFromRoot / Node.GetTotalBoneLength());
+		RecordDebugForce(Node, Bone.Index, Force * ForceRate);
+		AnimDrawDebug(Bone, Node, PoseContext);
 	}
+#endif
+}
+
+void FKawaiiPhysics_ExternalForce_Gravity::ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones,
+                                                      FAnimNode_KawaiiPhysics& Node,
+                                                      const FComponentSpacePoseContext& PoseContext,
+                                                      TConstArrayView<FTransform> BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_ExternalForce_Gravity_Apply);
+#if ENABLE_ANIM_DEBUG
+	const bool bRecordDebugForce = ShouldRecordDebugForce();
+#endif
 
-	Bone.Location += 0.5f * Force * ForceRate * Node.DeltaTime * Node.DeltaTime;
+	const FVector3f Displacement = FVector3f(0.5f * Force * Node.DeltaTime * Node.DeltaTime);
+
+	for (FKawaiiPhysicsModifyBone& Bone : Bones)
+	{
+		if (Bone.bSkipSimulate || !CanApply(Bone))
+		{
+			continue;
+		}
+
+		const float ForceRate = GetForceRate(Bone, Node, ForceRateByBoneLengthRate);
+		Bone.Location += Displacement * ForceRate;
 
 #if ENABLE_ANIM_DEBUG
-	BoneForceMap.Add(Bone.BoneRef.BoneName, Force * ForceRate);
-	AnimDrawDebug(Bone, Node, PoseContext);
+		if (bRecordDebugForce)
+		{
+			RecordDebugForce(Node, Bone.Index, Force * ForceRate);
+			AnimDrawDebug(Bone, Node, PoseContext);
+		}
 #endif
+	}
 }
 
 ///
@@ -155,18 +227,60 @@ void FKawaiiPhysics_ExternalForce_Curve::InitMaxCurveTime()
 	}
 }
 
+void FKawaiiPhysics_ExternalForce_Curve::InitCurveTable()
+{
+	MaxCurveTime = 0.0f;
+	InitMaxCurveTime();
+
+	CurveTable.Reset();
+	CurveTableInterval = 0.0f;
+	if (CurveSampleRate > 0 && MaxCurveTime > 0.0f)
+	{
+		const int32 NumSamples = FMath::CeilToInt32(MaxCurveTime * CurveSampleRate) + 1;
+		CurveTableInterval = MaxCurveTime / (NumSamples - 1);
+		CurveTable.SetNumUninitialized(NumSamples);
+		for (int32 i = 0; i < NumSamples; ++i)
+		{
+			CurveTable[i] = ForceCurve.GetValue(i * CurveTableInterval);
+		}
+	}
+
+	bCurveTableBuilt = true;
+}
+
+FVector FKawaiiPhysics_ExternalForce_Curve::SampleCurveTable(float InTime) const
+{
+	if (CurveTable.Num() < 2)
+	{
+		return ForceCurve.GetValue(InTime);
+	}
+
+	const float Position = InTime / CurveTableInterval;
+	const int32 Index = FMath::Clamp(FMath::FloorToInt32(Position), 0, CurveTable.Num() - 2);
+	return FMath::Lerp(CurveTable[Index], CurveTable[Index + 1], FMath::Clamp(Position - Index, 0.0f, 1.0f));
+}
+
 void FKawaiiPhysics_ExternalForce_Curve::Initialize(const FAnimationInitializeContext& Context)
 {
 	FKawaiiPhysics_ExternalForce::Initialize(Context);
 
-	InitMaxCurveTime();
+	InitCurveTable();
+}
+
+void FKawaiiPhysics_ExternalForce_Curve::InitBones(const FAnimNode_KawaiiPhysics& Node)
+{
+	Super::InitBones(Node);
+
+	BakeForceRates(Node, ForceRateByBoneLengthRate);
 }
 
 void FKawaiiPhysics_ExternalForce_Curve::PreApply(FAnimNode_KawaiiPhysics& Node, const USkeletalMeshComponent* SkelComp)
 {
-#if WITH_EDITOR
-	InitMaxCurveTime();
-#endif
+	// Forces copied for live editing are not initialized
+	if (!bCurveTableBuilt)
+	{
+		InitCurveTable();
+	}
 
 	PrevTime = Time;
 
@@ -177,60 +291,62 @@ void FKawaiiPhysics_ExternalForce_Curve::PreApply(FAnimNode_KawaiiPhysics& Node,
 		{
 			Time = FMath::Fmod(Time, MaxCurveTime);
 		}
-		Force = ForceCurve.GetValue(Time) * FMath::RandRange(RandomForceScale.Min, RandomForceScale.Max);
+		Force = ForceCurve.GetValue(Time) * GetRandomForceScale(Node);
 	}
 	else
 	{
-		TArray<FVector> CurveValues;
-		const float SubStep = Node.DeltaTime * TimeScale / SubstepCount;
+		const int32 NumSubsteps = FMath::Max(SubstepCount, 1);
+		const float SubStep = Node.DeltaTime * TimeScale / NumSubsteps;
 
-		for (int i = 0; i < SubstepCount; ++i)
+		switch (CurveEvaluateType)
+		{
+		case EExternalForceCurveEvaluateType::Max:
+			Force = FVector(-FLT_MAX);
+			break;
+		case EExternalForceCurveEvaluateType::Min:
+			Force = FVector(FLT_MAX);
+			break;
+		default:
+			Force = FVector::Zero();
+			break;
+		}
+
+		for (int i = 0; i < NumSubsteps; ++i)
 		{
 			Time += SubStep;
 			if (MaxCurveTime > 0 && Time > MaxCurveTime)
 			{
 				Time = FMath::Fmod(Time, MaxCurveTime);
 			}
-			CurveValues.Add(ForceCurve.GetValue(Time));
-		}
 
-		Force = FVector::Zero();
-		switch (CurveEvaluateType)
-		{
-		case EExternalForceCurveEvaluateType::Average:
-			for (const auto& CurveValue : CurveValues)
+			const FVector CurveValue = SampleCurveTable(Time);
+			switch (CurveEvaluateType)
 			{
+			case EExternalForceCurveEvaluateType::Average:
 				Force += CurveValue;
-			}
-			Force /= static_cast<float>(SubstepCount);
-
-			break;
-
-		case EExternalForceCurveEvaluateType::Max:
-			Force = FVector(FLT_MIN);
-			for (const auto& CurveValue : CurveValues)
-			{
+				break;
+			case EExternalForceCurveEvaluateType::Max:
 				Force = FVector::Max(Force, CurveValue);
-			}
-			break;
-		case EExternalForceCurveEvaluateType::Min:
-			Force = FVector(FLT_MAX);
-			for (const auto& CurveValue : CurveValues)
-			{
+				break;
+			case EExternalForceCurveEvaluateType::Min:
 				Force = FVector::Min(Force, CurveValue);
+				break;
+			default:
+				break;
 			}
-			break;
-		default:
-			break;
 		}
 
-		Force *= FMath::RandRange(RandomForceScale.Min, RandomForceScale.Max);
+		if (CurveEvaluateType == EExternalForceCurveEvaluateType::Average)
+		{
+			Force /= static_cast<float>(NumSubsteps);
+		}
+
+		Force *= GetRandomForceScale(Node);
 	}
 
 	if (ExternalForceSpace == EExternalForceSpace::WorldSpace)
 	{
-		const FTransform ComponentTransform = SkelComp->GetComponentTransform();
-		Force = ComponentTransform.InverseTransformVector(Force);
+		Force = Node.GetGameThreadInput().ComponentTransform.InverseTransformVector(Force);
 	}
 }
 
@@ -244,31 +360,70 @@ void FKawaiiPhysics_ExternalForce_Curve::Apply(FKawaiiPhysicsModifyBone& Bone, F
 
 	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_ExternalForce_Curve_Apply);
 
-	float ForceRate = 1.0f;
-	if (const auto Curve = ForceRateByBoneLengthRate.GetRichCurve(); !Curve->IsEmpty())
-	{
-		ForceRate = Curve->Eval(Bone.LengthFromRoot / Node.GetTotalBoneLength());
-	}
+	const float ForceRate = GetForceRate(Bone, Node, ForceRateByBoneLengthRate);
 
 	if (ExternalForceSpace == EExternalForceSpace::BoneSpace)
 	{
 		const FVector BoneForce = BoneTM.TransformVector(Force);
-		Bone.Location += BoneForce * ForceRate * Node.DeltaTime;
+		Bone.Location += FVector3f(BoneForce * ForceRate * Node.DeltaTime);
 
 #if ENABLE_ANIM_DEBUG
-		BoneForceMap.Add(Bone.BoneRef.BoneName, BoneForce * ForceRate);
+		if (ShouldRecordDebugForce())
+		{
+			RecordDebugForce(Node, Bone.Index, BoneForce * ForceRate);
+		}
 #endif
 	}
 	else
 	{
-		Bone.Location += Force * ForceRate * Node.DeltaTime;
+		Bone.Location += FVector3f(Force * ForceRate * Node.DeltaTime);
 
 #if ENABLE_ANIM_DEBUG
-		BoneForceMap.Add(Bone.BoneRef.BoneName, Force * ForceRate);
+		if (ShouldRecordDebugForce())
+		{
+			RecordDebugForce(Node, Bone.Index, Force * ForceRate);
+		}
 #endif
 	}
 
 #if ENABLE_ANIM_DEBUG
-	AnimDrawDebug(Bone, Node, PoseContext);
+	if (ShouldRecordDebugForce())
+	{
+		AnimDrawDebug(Bone, Node, PoseContext);
+	}
 #endif
 }
+
+void FKawaiiPhysics_ExternalForce_Curve::ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones,
+                                                    FAnimNode_KawaiiPhysics& Node,
+                                                    const FComponentSpacePoseContext& PoseContext,
+                                                    TConstArrayView<FTransform> BoneTransforms)
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_ExternalForce_Curve_Apply);
+#if ENABLE_ANIM_DEBUG
+	const bool bRecordDebugForce = ShouldRecordDebugForce();
+#endif
+
+	const bool bBoneSpace = ExternalForceSpace == EExternalForceSpace::BoneSpace;
+	const FVector3f Force3f = FVector3f(Force);
+
+	for (FKawaiiPhysicsModifyBone& Bone : Bones)
+	{
+		if (Bone.bSkipSimulate || !CanApply(Bone))
+		{
+			continue;
+		}
+
+		const float ForceRate = GetForceRate(Bone, Node, ForceRateByBoneLengthRate);
+		const FVector3f BoneForce = bBoneSpace ? FVector3f(BoneTransforms[Bone.Index].TransformVector(Force)) : Force3f;
+		Bone.Location += BoneForce * ForceRate * Node.DeltaTime;
+
+#if ENABLE_ANIM_DEBUG
+		if (bRecordDebugForce)
+		{
+			RecordDebugForce(Node, Bone.Index, FVector(BoneForce * ForceRate));
+			AnimDrawDebug(Bone, Node, PoseContext);
+		}
+#endif
+	}
+}
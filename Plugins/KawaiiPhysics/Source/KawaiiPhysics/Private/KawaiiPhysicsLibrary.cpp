@@ -26,6 +26,34 @@ FKawaiiPhysicsReference UKawaiiPhysicsLibrary::ResetDynamics(const FKawaiiPhysic
 	return KawaiiPhysics;
 }
 
+FKawaiiPhysicsReference UKawaiiPhysicsLibrary::SaveState(const FKawaiiPhysicsReference& KawaiiPhysics,
+                                                         TArray<uint8>& State, bool bQuantize)
+{
+	State.Reset();
+	KawaiiPhysics.CallAnimNodeFunction<FAnimNode_KawaiiPhysics>(
+		TEXT("SaveState"),
+		[&State, bQuantize](FAnimNode_KawaiiPhysics& InKawaiiPhysics)
+		{
+			InKawaiiPhysics.SaveState(State, bQuantize);
+		});
+
+	return KawaiiPhysics;
+}
+
+FKawaiiPhysicsReference UKawaiiPhysicsLibrary::RestoreState(const FKawaiiPhysicsReference& KawaiiPhysics,
+                                                            const TArray<uint8>& State, bool& bSuccess)
+{
+	bSuccess = false;
+	KawaiiPhysics.CallAnimNodeFunction<FAnimNode_KawaiiPhysics>(
+		TEXT("RestoreState"),
+		[&State, &bSuccess](FAnimNode_KawaiiPhysics& InKawaiiPhysics)
+		{
+			bSuccess = InKawaiiPhysics.RestoreState(State);
+		});
+
+	return KawaiiPhysics;
+}
+
 
 FKawaiiPhysicsReference UKawaiiPhysicsLibrary::SetRootBoneName(const FKawaiiPhysicsReference& KawaiiPhysics,
                                                                FName& RootBoneName)
@@ -5,8 +5,16 @@
 #include "AnimNode_KawaiiPhysics.h"
 #include "KawaiiPhysics.h"
 
+#include <atomic>
+
 DEFINE_LOG_CATEGORY(LogKawaiiPhysics);
 
+namespace KawaiiPhysicsLimitsDataAsset
+{
+	// 0 is "no asset" for the nodes
+	std::atomic<uint32> RevisionCounter{0};
+}
+
 struct FCollisionLimitDataCustomVersion
 {
 	enum Type
@@ -88,6 +96,7 @@ void UKawaiiPhysicsLimitsDataAsset::Sync()
 	SyncCollisionLimits(SphericalLimitsData, SphericalLimits);
 	SyncCollisionLimits(CapsuleLimitsData, CapsuleLimits);
 	SyncCollisionLimits(PlanarLimitsData, PlanarLimits);
+	UpdateRevision();
 }
 
 
@@ -145,10 +154,39 @@ USkeleton* UKawaiiPhysicsLimitsDataAsset::GetSkeleton(bool& bInvalidSkeletonIsEr
 #endif
 }
 
+void UKawaiiPhysicsLimitsDataAsset::UpdateRevision()
+{
+	Revision = ++KawaiiPhysicsLimitsDataAsset::RevisionCounter;
+}
+
+void UKawaiiPhysicsLimitsDataAsset::UpdateOffsetTransforms()
+{
+	auto Update = [](auto& Limits)
+	{
+		for (auto& Limit : Limits)
+		{
+			Limit.OffsetTransform = FTransform(Limit.OffsetRotation, Limit.OffsetLocation);
+		}
+	};
+	Update(SphericalLimits);
+	Update(CapsuleLimits);
+	Update(PlanarLimits);
+}
+
+void UKawaiiPhysicsLimitsDataAsset::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	UpdateRevision();
+}
+
 void UKawaiiPhysicsLimitsDataAsset::PostLoad()
 {
 	Super::PostLoad();
 
+	UpdateOffsetTransforms();
+	UpdateRevision();
+
 	if (GetLinkerCustomVersion(FCollisionLimitDataCustomVersion::GUID) <
 		FCollisionLimitDataCustomVersion::ChangeToBoneReference)
 	{
@@ -0,0 +1,186 @@
+﻿#include "KawaiiPhysicsSharedColliders.h"
+
+#include "KawaiiPhysicsLimitsDataAsset.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "Misc/ScopeLock.h"
+#include "PhysicsEngine/PhysicsAsset.h"
+#include "PhysicsEngine/SkeletalBodySetup.h"
+#include "UObject/ObjectKey.h"
+
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_UpdateSharedColliders"), STAT_KawaiiPhysics_UpdateSharedColliders,
+                   STATGROUP_Anim);
+
+namespace KawaiiPhysicsSharedColliders
+{
+	// Keyed by AnimInstanceProxy and LimitsDataAsset. The nodes own the sets, entries expire with their last node
+	TMap<TPair<const void*, const void*>, TWeakPtr<FKawaiiPhysicsColliderSet>> ColliderSets;
+	FCriticalSection ColliderSetsLock;
+
+	TMap<FObjectKey, TSharedPtr<const FKawaiiPhysicsPhysicsAssetLimits>> PhysicsAssetLimits;
+}
+
+TSharedPtr<FKawaiiPhysicsColliderSet> FKawaiiPhysicsColliderSet::FindOrAdd(
+	const FAnimInstanceProxy* AnimInstanceProxy, const UKawaiiPhysicsLimitsDataAsset* LimitsDataAsset)
+{
+	using namespace KawaiiPhysicsSharedColliders;
+
+	if (!AnimInstanceProxy || !LimitsDataAsset)
+	{
+		return nullptr;
+	}
+
+	// Nodes of different AnimInstances may initialize on different worker threads
+	FScopeLock Lock(&ColliderSetsLock);
+
+	for (auto It = ColliderSets.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TWeakPtr<FKawaiiPhysicsColliderSet>& WeakColliderSet = ColliderSets.FindOrAdd(
+		TPair<const void*, const void*>(AnimInstanceProxy, LimitsDataAsset));
+	if (TSharedPtr<FKawaiiPhysicsColliderSet> ColliderSet = WeakColliderSet.Pin())
+	{
+		return ColliderSet;
+	}
+
+	TSharedPtr<FKawaiiPhysicsColliderSet> ColliderSet = MakeShared<FKawaiiPhysicsColliderSet>();
+	ColliderSet->LimitsDataAsset = LimitsDataAsset;
+	WeakColliderSet = ColliderSet;
+	return ColliderSet;
+}
+
+void FKawaiiPhysicsColliderSet::InitPoseGather(const FBoneContainer& BoneContainer)
+{
+	const UKawaiiPhysicsLimitsDataAsset* DataAsset = LimitsDataAsset.Get();
+	AppliedRevision = DataAsset ? DataAsset->GetRevision() : 0;
+
+	PoseGatherIndices.Reset();
+	TMap<int32, int32> SlotByCompactPoseIndex;
+	auto AddLimits = [&](const auto& Limits, TArray<FKawaiiPhysicsLimitInstance>& Instances)
+	{
+		Instances.Reset();
+		Instances.SetNum(Limits.Num());
+		for (int32 i = 0; i < Limits.Num(); ++i)
+		{
+			FBoneReference DrivingBone = Limits[i].DrivingBone;
+			if (!DrivingBone.Initialize(BoneContainer) || !DrivingBone.IsValidToEvaluate(BoneContainer))
+			{
+				continue;
+			}
+
+			const FCompactPoseBoneIndex CompactPoseIndex = DrivingBone.GetCompactPoseIndex(BoneContainer);
+			if (const int32* Slot = SlotByCompactPoseIndex.Find(CompactPoseIndex.GetInt()))
+			{
+				Instances[i].PoseGatherSlot = *Slot;
+			}
+			else
+			{
+				Instances[i].PoseGatherSlot = SlotByCompactPoseIndex.Add(CompactPoseIndex.GetInt(),
+				                                                         PoseGatherIndices.Add(CompactPoseIndex));
+			}
+		}
+	};
+	AddLimits(DataAsset ? DataAsset->SphericalLimits : TArray<FSphericalLimit>(), SphericalLimitInstances);
+	AddLimits(DataAsset ? DataAsset->CapsuleLimits : TArray<FCapsuleLimit>(), CapsuleLimitInstances);
+	AddLimits(DataAsset ? DataAsset->PlanarLimits : TArray<FPlanarLimit>(), PlanarLimitInstances);
+
+	PoseGatherBoneContainer = &BoneContainer;
+	PoseGatherBoneContainerSerial = BoneContainer.GetSerialNumber();
+}
+
+void FKawaiiPhysicsColliderSet::Update(FComponentSpacePoseContext& Output)
+{
+	if (EvaluationCounter.IsSynchronized_Counter(Output.AnimInstanceProxy->GetEvaluationCounter()))
+	{
+		return;
+	}
+	EvaluationCounter.SynchronizeWith(Output.AnimInstanceProxy->GetEvaluationCounter());
+
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_UpdateSharedColliders);
+
+	// The asset's revision changes when it is edited (e.g. during PIE), as the unshared nodes check it
+	const FBoneContainer& BoneContainer = Output.Pose.GetPose().GetBoneContainer();
+	const UKawaiiPhysicsLimitsDataAsset* DataAsset = LimitsDataAsset.Get();
+	if (PoseGatherBoneContainer != &BoneContainer || PoseGatherBoneContainerSerial != BoneContainer.GetSerialNumber()
+		|| (DataAsset ? DataAsset->GetRevision() : 0) != AppliedRevision)
+	{
+		InitPoseGather(BoneContainer);
+	}
+
+	BoneTransformsCS.SetNumUninitialized(PoseGatherIndices.Num());
+	for (int32 Slot = 0; Slot < PoseGatherIndices.Num(); ++Slot)
+	{
+		BoneTransformsCS[Slot] = Output.Pose.GetComponentSpaceTransform(PoseGatherIndices[Slot]);
+	}
+
+	if (!DataAsset)
+	{
+		return;
+	}
+	FAnimNode_KawaiiPhysics::UpdateSphericalLimits(DataAsset->SphericalLimits, SphericalLimitInstances,
+	                                               BoneTransformsCS);
+	FAnimNode_KawaiiPhysics::UpdateCapsuleLimits(DataAsset->CapsuleLimits, CapsuleLimitInstances, BoneTransformsCS);
+	FAnimNode_KawaiiPhysics::UpdatePlanerLimits(DataAsset->PlanarLimits, PlanarLimitInstances, BoneTransformsCS);
+}
+
+TSharedPtr<const FKawaiiPhysicsPhysicsAssetLimits> FKawaiiPhysicsPhysicsAssetLimits::FindOrAdd(
+	const UPhysicsAsset* PhysicsAsset)
+{
+	using namespace KawaiiPhysicsSharedColliders;
+
+	check(IsInGameThread());
+
+	if (!PhysicsAsset)
+	{
+		return nullptr;
+	}
+
+	for (auto It = PhysicsAssetLimits.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	if (const TSharedPtr<const FKawaiiPhysicsPhysicsAssetLimits>* Limits = PhysicsAssetLimits.Find(PhysicsAsset))
+	{
+		return *Limits;
+	}
+
+	const TSharedPtr<FKawaiiPhysicsPhysicsAssetLimits> Limits = MakeShared<FKawaiiPhysicsPhysicsAssetLimits>();
+	for (const USkeletalBodySetup* BodySetup : PhysicsAsset->SkeletalBodySetups)
+	{
+		if (!BodySetup)
+		{
+			continue;
+		}
+
+		// Element transforms are relative to the body's bone, as limit offsets are
+		for (const FKSphereElem& Sphere : BodySetup->AggGeom.SphereElems)
+		{
+			FSphericalLimit& Limit = Limits->SphericalLimits.AddDefaulted_GetRef();
+			Limit.DrivingBone.BoneName = BodySetup->BoneName;
+			Limit.OffsetLocation = Sphere.Center;
+			Limit.Radius = Sphere.Radius;
+		}
+
+		// Both sphyls and capsule limits are aligned on Z, Length excludes the hemispheres
+		for (const FKSphylElem& Sphyl : BodySetup->AggGeom.SphylElems)
+		{
+			FCapsuleLimit& Limit = Limits->CapsuleLimits.AddDefaulted_GetRef();
+			Limit.DrivingBone.BoneName = BodySetup->BoneName;
+			Limit.OffsetLocation = Sphyl.Center;
+			Limit.OffsetRotation = Sphyl.Rotation;
+			Limit.Radius = Sphyl.Radius;
+			Limit.Length = Sphyl.Length;
+		}
+	}
+
+	PhysicsAssetLimits.Add(PhysicsAsset, Limits);
+	return Limits;
+}
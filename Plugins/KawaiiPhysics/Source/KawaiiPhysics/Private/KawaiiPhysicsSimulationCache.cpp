@@ -0,0 +1,177 @@
+﻿#include "KawaiiPhysicsSimulationCache.h"
+
+#include "AnimNode_KawaiiPhysics.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(KawaiiPhysicsSimulationCache)
+
+DECLARE_CYCLE_STAT(TEXT("KawaiiPhysics_SimulationCache_Sample"), STAT_KawaiiPhysics_SimulationCache_Sample,
+                   STATGROUP_Anim);
+
+FVector3f UKawaiiPhysicsSimulationCache::GetLocation(int32 Frame, int32 BoneIndex) const
+{
+	const int32 Index = (Frame * NumBones + BoneIndex) * 3;
+	const FVector3f Normalized(QuantizedLocations[Index], QuantizedLocations[Index + 1],
+	                           QuantizedLocations[Index + 2]);
+	return BoundsMin[BoneIndex] + Normalized * BoundsSize[BoneIndex] / static_cast<float>(MAX_uint16);
+}
+
+void UKawaiiPhysicsSimulationCache::SampleLocations(float Time, TArrayView<FKawaiiPhysicsModifyBone> Bones) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_KawaiiPhysics_SimulationCache_Sample);
+
+	const float FrameTime = FMath::Clamp(Time * FrameRate, 0.0f, static_cast<float>(NumFrames - 1));
+	const int32 Frame0 = FMath::FloorToInt32(FrameTime);
+	const int32 Frame1 = FMath::Min(Frame0 + 1, NumFrames - 1);
+	const float Alpha = FrameTime - Frame0;
+
+	for (int32 i = 0; i < Bones.Num(); ++i)
+	{
+		FKawaiiPhysicsModifyBone& Bone = Bones[i];
+		Bone.Location = FMath::Lerp(GetLocation(Frame0, i), GetLocation(Frame1, i), Alpha);
+		// Switching back to the simulation starts without velocity
+		Bone.PrevLocation = Bone.Location;
+	}
+}
+
+void UKawaiiPhysicsSimulationCache::BeginRecording(int32 InNumBones)
+{
+	RecordingLocations.Reset();
+	if (InNumBones == NumBones && QuantizedLocations.Num() == NumFrames * NumBones * 3)
+	{
+		RecordingLocations.SetNumUninitialized(NumFrames * NumBones);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int32 i = 0; i < NumBones; ++i)
+			{
+				RecordingLocations[Frame * NumBones + i] = GetLocation(Frame, i);
+			}
+		}
+	}
+	else
+	{
+		NumBones = InNumBones;
+		NumFrames = 0;
+		Keyframes.Reset();
+	}
+	bRecording = true;
+}
+
+void UKawaiiPhysicsSimulationCache::RecordFrame(int32 Frame, TConstArrayView<FKawaiiPhysicsModifyBone> Bones,
+                                               float DeltaTime)
+{
+	if (!bRecording || Bones.Num() != NumBones)
+	{
+		return;
+	}
+
+	// Only when recording starts past the frames in the cache, the node simulates one step per frame otherwise
+	const int32 FirstFrame = FMath::Min(NumFrames, Frame);
+	NumFrames = Frame + 1;
+	RecordingLocations.SetNum(NumFrames * NumBones);
+	for (int32 RecordedFrame = FirstFrame; RecordedFrame <= Frame; ++RecordedFrame)
+	{
+		for (int32 i = 0; i < NumBones; ++i)
+		{
+			RecordingLocations[RecordedFrame * NumBones + i] = Bones[i].Location;
+		}
+	}
+
+	Keyframes.RemoveAll([Frame](const FKawaiiPhysicsSimulationCacheKeyframe& Keyframe)
+	{
+		return Keyframe.Frame >= Frame;
+	});
+	// Crossing the boundary rather than landing on it : a low update rate may skip the exact frame
+	const int32 Interval = FMath::Max(KeyframeInterval, 1);
+	if (Keyframes.IsEmpty() || Frame / Interval != Keyframes.Last().Frame / Interval)
+	{
+		FKawaiiPhysicsSimulationCacheKeyframe& Keyframe = Keyframes.AddDefaulted_GetRef();
+		Keyframe.Frame = Frame;
+		Keyframe.DeltaTime = DeltaTime;
+		Keyframe.Locations.SetNumUninitialized(NumBones);
+		Keyframe.PrevLocations.SetNumUninitialized(NumBones);
+		for (int32 i = 0; i < NumBones; ++i)
+		{
+			Keyframe.Locations[i] = Bones[i].Location;
+			Keyframe.PrevLocations[i] = Bones[i].PrevLocation;
+		}
+	}
+}
+
+int32 UKawaiiPhysicsSimulationCache::RestoreKeyframe(int32 Frame, TArrayView<FKawaiiPhysicsModifyBone> Bones,
+                                                     float& OutDeltaTime)
+{
+	// Keyframes are sorted by frame
+	const FKawaiiPhysicsSimulationCacheKeyframe* Found = nullptr;
+	for (const FKawaiiPhysicsSimulationCacheKeyframe& Keyframe : Keyframes)
+	{
+		if (Keyframe.Frame > Frame)
+		{
+			break;
+		}
+		Found = &Keyframe;
+	}
+	if (!Found || Found->Locations.Num() != Bones.Num())
+	{
+		return INDEX_NONE;
+	}
+
+	for (int32 i = 0; i < Bones.Num(); ++i)
+	{
+		Bones[i].Location = Found->Locations[i];
+		Bones[i].PrevLocation = Found->PrevLocations[i];
+	}
+
+	if (bRecording)
+	{
+		NumFrames = FMath::Min(NumFrames, Found->Frame + 1);
+		RecordingLocations.SetNum(NumFrames * NumBones);
+	}
+	OutDeltaTime = Found->DeltaTime;
+	return Found->Frame;
+}
+
+void UKawaiiPhysicsSimulationCache::FinishRecording()
+{
+	if (!bRecording)
+	{
+		return;
+	}
+	bRecording = false;
+
+	BoundsMin.SetNumUninitialized(NumBones);
+	BoundsSize.SetNumUninitialized(NumBones);
+	for (int32 i = 0; i < NumBones; ++i)
+	{
+		FVector3f Min(MAX_flt);
+		FVector3f Max(-MAX_flt);
+		for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const FVector3f& Location = RecordingLocations[Frame * NumBones + i];
+			Min = FVector3f::Min(Min, Location);
+			Max = FVector3f::Max(Max, Location);
+		}
+		BoundsMin[i] = NumFrames > 0 ? Min : FVector3f::ZeroVector;
+		BoundsSize[i] = NumFrames > 0 ? Max - Min : FVector3f::ZeroVector;
+	}
+
+	QuantizedLocations.SetNumUninitialized(NumFrames * NumBones * 3);
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		for (int32 i = 0; i < NumBones; ++i)
+		{
+			const FVector3f& Location = RecordingLocations[Frame * NumBones + i];
+			const int32 Index = (Frame * NumBones + i) * 3;
+			for (int32 Axis = 0; Axis < 3; ++Axis)
+			{
+				const float Normalized = BoundsSize[i][Axis] > UE_SMALL_NUMBER
+					                         ? (Location[Axis] - BoundsMin[i][Axis]) / BoundsSize[i][Axis]
+					                         : 0.0f;
+				QuantizedLocations[Index + Axis] = static_cast<uint16>(
+					FMath::Clamp(FMath::RoundToInt32(Normalized * MAX_uint16), 0, MAX_uint16));
+			}
+		}
+	}
+	RecordingLocations.Empty();
+
+	MarkPackageDirty();
+}
@@ -4,6 +4,8 @@
 #include "BoneControllers/AnimNode_AnimDynamics.h"
 #include "BoneContainer.h"
 #include "BonePose.h"
+#include "CollisionQueryParams.h"
+#include "KawaiiPhysicsSimulationCache.h"
 #include "InstancedStruct.h"
 #include "BoneControllers/AnimNode_SkeletalControlBase.h"
 #include "AnimNode_KawaiiPhysics.generated.h"
@@ -11,6 +13,9 @@
 class UKawaiiPhysics_CustomExternalForce;
 class UKawaiiPhysicsLimitsDataAsset;
 class UKawaiiPhysicsBoneConstraintsDataAsset;
+struct FKawaiiPhysicsColliderSet;
+class UPhysicsAsset;
+class UPrimitiveComponent;
 
 UENUM()
 enum class EPlanarConstraint : uint8
@@ -56,15 +61,22 @@ struct FCollisionLimitBase
 	UPROPERTY(EditAnywhere, Category = CollisionLimitBase, meta = (ClampMin = "-360", ClampMax = "360"))
 	FRotator OffsetRotation = FRotator::ZeroRotator;
 
+	// Simulation runs in component space : single precision is enough
 	UPROPERTY()
-	FVector Location = FVector::ZeroVector;
+	FVector3f Location = FVector3f::ZeroVector;
 
 	UPROPERTY()
-	FQuat Rotation = FQuat::Identity;
+	FQuat4f Rotation = FQuat4f::Identity;
 
 	UPROPERTY()
 	bool bEnable = true;
 
+	// Index of DrivingBone's transform in the node's gathered pose, INDEX_NONE if it is not in the pose
+	int32 PoseGatherSlot = INDEX_NONE;
+
+	// OffsetLocation/OffsetRotation, built with PoseGatherSlot
+	FTransform OffsetTransform = FTransform::Identity;
+
 #if WITH_EDITORONLY_DATA
 
 	UPROPERTY()
@@ -118,6 +130,10 @@ struct FCapsuleLimit : public FCollisionLimitBase
 
 	UPROPERTY(EditAnywhere, Category = CapsuleLimit, meta = (ClampMin = "0"))
 	float Length = 10.0f;
+
+	// Ends of the capsule axis in component space, updated with Location/Rotation
+	FVector3f StartPoint = FVector3f::ZeroVector;
+	FVector3f EndPoint = FVector3f::ZeroVector;
 };
 
 USTRUCT(BlueprintType)
@@ -133,7 +149,26 @@ struct FPlanarLimit : public FCollisionLimitBase
 	}
 
 	UPROPERTY()
-	FPlane Plane = FPlane(0, 0, 0, 0);
+	FPlane4f Plane = FPlane4f(0, 0, 0, 0);
+};
+
+/**
+* LimitsDataAssetのコリジョンのノードごとの状態。形状・DrivingBone・オフセットはアセットから直接読み取ります
+* Per node state of a collider defined in a LimitsDataAsset, index for index with the asset's limits.
+* The shape, DrivingBone and offsets are read from the asset : only what this node's pose drives lives here
+*/
+struct FKawaiiPhysicsLimitInstance
+{
+	FVector3f Location = FVector3f::ZeroVector;
+	FQuat4f Rotation = FQuat4f::Identity;
+	// Capsule : ends of the axis
+	FVector3f StartPoint = FVector3f::ZeroVector;
+	FVector3f EndPoint = FVector3f::ZeroVector;
+	// Planar
+	FPlane4f Plane = FPlane4f(0, 0, 0, 0);
+	// Index of DrivingBone's transform in the gathered pose, INDEX_NONE if it is not in the pose
+	int32 PoseGatherSlot = INDEX_NONE;
+	bool bEnable = false;
 };
 
 USTRUCT(BlueprintType)
@@ -191,30 +226,30 @@ struct KAWAIIPHYSICS_API FKawaiiPhysicsModifyBone
 	GENERATED_USTRUCT_BODY()
 
 public:
-	UPROPERTY()
-	FBoneReference BoneRef;
+	// The bone is FAnimNode_KawaiiPhysics::ModifyBoneRefs[Index] and the animated pose
+	// FAnimNode_KawaiiPhysics::GetBoneTransformCS(Index), so that only the solver state is touched per frame
 	UPROPERTY(BlueprintReadOnly)
 	int32 Index = -1;
 	UPROPERTY(BlueprintReadOnly)
 	int32 ParentIndex = -1;
+	// Children are FAnimNode_KawaiiPhysics::ModifyBoneChildIndices[FirstChildIndex, FirstChildIndex + NumChildren)
 	UPROPERTY(BlueprintReadOnly)
-	TArray<int32> ChildIndexs;
+	int32 FirstChildIndex = 0;
+	UPROPERTY(BlueprintReadOnly)
+	int32 NumChildren = 0;
 
 	UPROPERTY(BlueprintReadOnly)
 	FKawaiiPhysicsSettings PhysicsSettings;
 
-	UPROPERTY(BlueprintReadWrite)
-	FVector Location = FVector::ZeroVector;
-	UPROPERTY(BlueprintReadOnly)
-	FVector PrevLocation = FVector::ZeroVector;
-	UPROPERTY(BlueprintReadOnly)
-	FQuat PrevRotation = FQuat::Identity;
-	UPROPERTY(BlueprintReadOnly)
-	FVector PoseLocation = FVector::ZeroVector;
-	UPROPERTY(BlueprintReadOnly)
-	FQuat PoseRotation = FQuat::Identity;
-	UPROPERTY(BlueprintReadOnly)
-	FVector PoseScale = FVector::OneVector;
+	// Solver state is in component space and single precision. Converted at the pose input/output only.
+	// Use UKawaiiPhysicsLibrary::Get/SetModifyBoneLocation etc. from Blueprint. Break/Set Members nodes using them
+	// are rewritten when the Blueprint is compiled in the editor (see KawaiiPhysics.MigrateModifyBoneBlueprints)
+	UPROPERTY()
+	FVector3f Location = FVector3f::ZeroVector;
+	UPROPERTY()
+	FVector3f PrevLocation = FVector3f::ZeroVector;
+	UPROPERTY()
+	FQuat4f PrevRotation = FQuat4f::Identity;
 	UPROPERTY(BlueprintReadOnly)
 	float LengthFromRoot = 0.0f;
 	UPROPERTY(BlueprintReadOnly)
@@ -223,28 +258,6 @@ public:
 	bool bSkipSimulate = false;
 
 public:
-	void UpdatePoseTransform(const FBoneContainer& BoneContainer, FCSPose<FCompactPose>& Pose,
-	                         bool ResetBoneTransformWhenBoneNotFound)
-	{
-		const auto CompactPoseIndex = BoneRef.GetCompactPoseIndex(BoneContainer);
-		if (CompactPoseIndex < 0)
-		{
-			// Reset bone location and rotation may cause trouble when switching between skeleton LODs #44
-			if (ResetBoneTransformWhenBoneNotFound)
-			{
-				PoseLocation = FVector::ZeroVector;
-				PoseRotation = FQuat::Identity;
-				PoseScale = FVector::OneVector;
-			}
-			return;
-		}
-
-		const auto ComponentSpaceTransform = Pose.GetComponentSpaceTransform(CompactPoseIndex);
-		PoseLocation = ComponentSpaceTransform.GetLocation();
-		PoseRotation = ComponentSpaceTransform.GetRotation();
-		PoseScale = ComponentSpaceTransform.GetScale3D();
-	}
-
 	FKawaiiPhysicsModifyBone()
 	{
 	}
@@ -322,6 +335,76 @@ struct FModifyBoneConstraint
 	}
 };
 
+// Valid constraint of MergedBoneConstraints baked for the simulation loop
+struct FKawaiiPhysicsBoneConstraintRuntime
+{
+	int32 ModifyBoneIndex1 = INDEX_NONE;
+	int32 ModifyBoneIndex2 = INDEX_NONE;
+	float Length = 0.0f;
+	// XPBD compliance of the constraint's type, and divided by DeltaTime^2 once per frame
+	float Compliance = 0.0f;
+	float ScaledCompliance = 0.0f;
+	float Lambda = 0.0f;
+	// Follows BoneConstraintGlobalComplianceType which can change at runtime
+	bool bGlobalCompliance = true;
+};
+
+// Game thread state read by the evaluation, captured in PreUpdate so that the worker thread does not touch UObjects.
+// External forces run PreApply in PreUpdate too. Two exceptions remain : world collision sweeps World on the worker
+// thread (as the engine's own anim nodes do), and the deprecated per bone UKawaiiPhysics_CustomExternalForce::Apply
+// still receives the SkeletalMeshComponent
+struct FKawaiiPhysicsGameThreadInput
+{
+	// False while evaluated without a component
+	bool bValid = false;
+	FTransform ComponentTransform = FTransform::Identity;
+
+	// Owner character's gravity (FKawaiiPhysics_ExternalForce_Gravity)
+	bool bHasCharacter = false;
+	bool bHasCharacterMovement = false;
+	FVector CharacterGravityDirection = FVector(0, 0, -1.0f);
+	float CharacterGravityZ = 0.0f;
+
+	// Wind at the chain root/tip in component space
+	bool bWindSampled = false;
+	FVector3f WindVelocityAtRoot = FVector3f::ZeroVector;
+	FVector3f WindVelocityAtTip = FVector3f::ZeroVector;
+
+	// World collision. OwningComp is only compared with the hit components, never dereferenced
+	const UWorld* World = nullptr;
+	const UPrimitiveComponent* OwningComp = nullptr;
+	ECollisionChannel CollisionChannel = ECC_WorldDynamic;
+	FCollisionResponseParams CollisionResponseParams;
+	FCollisionQueryParams CollisionQueryParams;
+	// Component and bIgnoreSelfComponent CollisionQueryParams was built for : AddIgnoredComponent allocates
+	TWeakObjectPtr<const UPrimitiveComponent> CollisionQueryComp;
+	bool bCollisionQueryIgnoresComp = false;
+};
+
+// Heap memory of one node by category, listed by a.AnimNode.KawaiiPhysics.MemReport
+struct FKawaiiPhysicsMemoryUsage
+{
+	// ModifyBones, child indices, self collision chains and output order
+	SIZE_T Bones = 0;
+	// Gathered bone transforms and their pose indices
+	SIZE_T PoseCache = 0;
+	// Limits of the node, its data asset copies and the PhysicsAsset limits
+	SIZE_T Colliders = 0;
+	SIZE_T Constraints = 0;
+	SIZE_T ExternalForces = 0;
+	// Self collision spatial hash
+	SIZE_T Scratch = 0;
+
+	// Shared with the other nodes of the AnimInstance : count once per set
+	const void* SharedColliders = nullptr;
+	SIZE_T SharedCollidersSize = 0;
+
+	SIZE_T GetTotal() const
+	{
+		return Bones + PoseCache + Colliders + Constraints + ExternalForces + Scratch;
+	}
+};
+
 USTRUCT(BlueprintType)
 struct KAWAIIPHYSICS_API FAnimNode_KawaiiPhysics : public FAnimNode_SkeletalControlBase
 {
@@ -520,24 +603,57 @@ public:
 	*/
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Limits", meta = (PinHiddenByDefault))
 	TObjectPtr<UKawaiiPhysicsLimitsDataAsset> LimitsDataAsset = nullptr;
-	/** 
-	* コリジョン設定（DataAsset版）における球コリジョンのプレビュー
-	* Preview of sphere collision in collision settings (DataAsset version)
+
+	/**
+	* LimitsDataAssetのコリジョンを同じAnimInstanceの他のKawaiiPhysicsノードと共有し、評価ごとに1回だけ更新します。
+	* 間のノードがDrivingBoneを動かさない場合（体のコリジョンを髪・スカート・尻尾で使う等）に有効にしてください
+	* Share the colliders of LimitsDataAsset with the other KawaiiPhysics nodes of the same AnimInstance,
+	* updated once per evaluation. Enable it when the nodes in between do not move the DrivingBones
+	* (e.g. body colliders used by hair, skirt and tail nodes). Not used while editing in the AnimBP editor.
 	*/
-	UPROPERTY(VisibleAnywhere, AdvancedDisplay, Category = "Limits")
-	TArray<FSphericalLimit> SphericalLimitsData;
-	/** 
-	* コリジョン設定（DataAsset版）におけるカプセルコリジョンのプレビュー
-	* Preview of capsule collision in collision settings (DataAsset version)
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "Limits")
+	bool bShareLimitsDataAsset = false;
+
+	/**
+	* SkeletalMeshComponentのPhysicsAssetの球・カプセルをコリジョンとして使用します。
+	* 自身のチェーンとIgnoreBones・IgnoreBoneNamePrefixのボーンは除外されます。WorldCollisionで自身と判定するより大幅に軽量です
+	* Use the sphere and capsule (sphyl) bodies of the SkeletalMeshComponent's PhysicsAsset as limits.
+	* Bodies on this chain and on IgnoreBones / IgnoreBoneNamePrefix are skipped.
+	* Much cheaper than colliding with the own PhysicsAsset through WorldCollision.
 	*/
-	UPROPERTY(VisibleAnywhere, AdvancedDisplay, Category = "Limits")
-	TArray<FCapsuleLimit> CapsuleLimitsData;
-	/** 
-	* コリジョン設定（DataAsset版）における平面コリジョンのプレビュー
-	* Preview of planar collision in collision settings (DataAsset version)
+	UPROPERTY(EditAnywhere, Category = "Limits")
+	bool bUsePhysicsAssetAsLimits = false;
+	/**
+	* PhysicsAssetから生成した球コリジョンのプレビュー
+	* Preview of sphere collision generated from the PhysicsAsset
+	*/
+	UPROPERTY(VisibleAnywhere, Transient, AdvancedDisplay, Category = "Limits")
+	TArray<FSphericalLimit> SphericalLimitsPhysicsAsset;
+	/**
+	* PhysicsAssetから生成したカプセルコリジョンのプレビュー
+	* Preview of capsule collision generated from the PhysicsAsset
+	*/
+	UPROPERTY(VisibleAnywhere, Transient, AdvancedDisplay, Category = "Limits")
+	TArray<FCapsuleLimit> CapsuleLimitsPhysicsAsset;
+
+	/**
+	* このノード内の異なるチェーン（スカートのパネル、髪の束など）のボーン同士のコリジョン。各ボーンのRadiusを使用します
+	* Collision between bones of different chains of this node (e.g. skirt panels, hair strands), using each bone's Radius.
+	* Parent/child and sibling pairs are skipped. Bones are bucketed in a spatial hash rebuilt every frame,
+	* so the cost stays near linear in bone count.
 	*/
-	UPROPERTY(VisibleAnywhere, AdvancedDisplay, Category = "Limits")
-	TArray<FPlanarLimit> PlanarLimitsData;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Limits", meta = (PinHiddenByDefault))
+	bool bEnableSelfCollision = false;
+
+	/**
+	* 親ボーンから子ボーンへの線分（ボーンのRadiusのカプセル）で球・カプセルコリジョンと判定し、両端を押し出します。
+	* 細いコリジョンがボーンの間をすり抜けるのを防ぎ、少ないボーン数や低い更新頻度でも安定します
+	* Collide the parent-to-child segment (a capsule with the bone's Radius) against sphere and capsule limits,
+	* pushing both ends. Thin colliders no longer slip between bones, so chains hold up with fewer bones
+	* or at lower update rates. Planes are already handled by the ends.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Limits", meta = (PinHiddenByDefault))
+	bool bUseSegmentCollision = false;
 
 	/** 
 	* Bone Constraintで用いる剛性タイプ
@@ -584,14 +700,17 @@ public:
 		meta = (PinHiddenByDefault))
 	TObjectPtr<UKawaiiPhysicsBoneConstraintsDataAsset> BoneConstraintsDataAsset;
 
+#if WITH_EDITORONLY_DATA
 	/** 
 	* BoneConstraint処理の対象となるボーンのペアのプレビュー
 	* Preview of bone pairs that will be processed by BoneConstraint
 	*/
-	UPROPERTY(VisibleAnywhere, Category = "Bone Constraint (Experimental)", AdvancedDisplay,
+	UPROPERTY(VisibleAnywhere, Transient, Category = "Bone Constraint (Experimental)", AdvancedDisplay,
 		meta=(TitleProperty="{Bone1} - {Bone2}"))
 	TArray<FModifyBoneConstraint> BoneConstraintsData;
-	UPROPERTY()
+#endif
+	// BoneConstraints and BoneConstraintsDataAsset resolved against ModifyBones, rebuilt in InitBoneConstraints
+	UPROPERTY(Transient)
 	TArray<FModifyBoneConstraint> MergedBoneConstraints;
 
 	/** 
@@ -614,6 +733,22 @@ public:
 		meta = (PinHiddenByDefault))
 	float WindScale = 1.0f;
 
+	/**
+	* 風・外力のランダム値に使用するシード値。同じシードなら同じ結果を再現可能
+	* Seed of the random stream used for wind gusts and RandomForceScale of external forces. Same seed reproduces the same result
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ExternalForce", AdvancedDisplay,
+		meta = (PinHiddenByDefault))
+	int32 RandomSeed = 0;
+
+	/**
+	* シード値にオーナーアクターの名前を加味するフラグ。同じABPを使う複数キャラの揺れをずらす目的
+	* Combine RandomSeed with the owner actor's name, so that characters sharing the same ABP do not move in sync
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "ExternalForce", AdvancedDisplay,
+		meta = (PinHiddenByDefault))
+	bool bDeriveRandomSeedFromOwner = false;
+
 	/** 
 	* 外力のプリセット。C++で独自のプリセットを追加可能(Instanced Struct)
 	* External force presets. You can add your own presets in C++.
@@ -665,18 +800,57 @@ public:
 	* WorldCollisionにて、SkeletalMeshComponentが持つコリジョン(PhysicsAsset)を無視する設定（骨）
 	* In WorldCollision, set to ignore collision (PhysicsAsset) of SkeletalMeshComponent using bone
 	*/
-	UPROPERTY(EditAnywhere, Category = "World Collision", meta = (EditCondition = "!bIgnoreSelfComponent"))
+	UPROPERTY(EditAnywhere, Category = "World Collision",
+		meta = (EditCondition = "!bIgnoreSelfComponent || bUsePhysicsAssetAsLimits"))
 	TArray<FBoneReference> IgnoreBones;
 	/** 
 	* WorldCollisionにて、SkeletalMeshComponentが持つコリジョン(PhysicsAsset)を無視する設定（骨名のプリフィックス）
 	* In WorldCollision, set to ignore collision (PhysicsAsset) of SkeletalMeshComponent using bone name prefix
 	*/
-	UPROPERTY(EditAnywhere, Category = "World Collision", meta = (EditCondition = "!bIgnoreSelfComponent"))
+	UPROPERTY(EditAnywhere, Category = "World Collision",
+		meta = (EditCondition = "!bIgnoreSelfComponent || bUsePhysicsAssetAsLimits"))
 	TArray<FName> IgnoreBoneNamePrefix;
 
+	/**
+	* Record : シミュレーション結果をSimulationCacheに記録。Playback : シミュレーションせずにSimulationCacheを再生
+	* Record : write the simulation into SimulationCache. Playback : play SimulationCache back instead of simulating,
+	* for takes that give the same result every time (e.g. Sequencer renders).
+	* While recording the simulation steps 1 / FrameRate per cache frame and holds while the frame does not advance
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation Cache", meta = (PinHiddenByDefault))
+	EKawaiiPhysicsSimulationCacheMode SimulationCacheMode = EKawaiiPhysicsSimulationCacheMode::None;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation Cache",
+		meta = (PinHiddenByDefault, EditCondition = "SimulationCacheMode != EKawaiiPhysicsSimulationCacheMode::None"))
+	TObjectPtr<UKawaiiPhysicsSimulationCache> SimulationCache;
+
+	/**
+	* 記録・再生する時間。Sequencerなどから指定する場合はbAdvanceSimulationCacheTimeをオフにしてピンで渡してください
+	* Time recorded or played back. To follow Sequencer, turn bAdvanceSimulationCacheTime off and drive this pin
+	* with the sequence time. Jumping back while recording resumes from the nearest keyframe of the cache
+	* and simulates the frames from there to the new time again
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation Cache",
+		meta = (PinHiddenByDefault, EditCondition = "SimulationCacheMode != EKawaiiPhysicsSimulationCacheMode::None"))
+	float SimulationCacheTime = 0.0f;
+
+	/**
+	* SimulationCacheTimeをノードの経過時間で進める
+	* Advance SimulationCacheTime by the node's delta time
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Simulation Cache",
+		meta = (PinHiddenByDefault, EditCondition = "SimulationCacheMode != EKawaiiPhysicsSimulationCacheMode::None"))
+	bool bAdvanceSimulationCacheTime = true;
+
 	UPROPERTY(BlueprintReadWrite, Category = "Bones")
 	TArray<FKawaiiPhysicsModifyBone> ModifyBones;
 
+	// Children of all ModifyBones in one allocation, see FKawaiiPhysicsModifyBone::FirstChildIndex
+	TArray<int32> ModifyBoneChildIndices;
+
+	// Bone of each ModifyBone (None for dummy bones), built with ModifyBones and only read when resolving bones
+	TArray<FBoneReference> ModifyBoneRefs;
+
 	UPROPERTY(BlueprintReadWrite)
 	float DeltaTime;
 
@@ -693,12 +867,69 @@ protected:
 	bool bEditing = false;
 #endif
 
-	FVector SkelCompMoveVector;
-	FQuat SkelCompMoveRotation;
+	FVector3f SkelCompMoveVector;
+	FQuat4f SkelCompMoveRotation;
 
 	float DeltaTimeOld;
 	bool bResetDynamics;
 
+	// Per node stream so that worker threads do not share the global RNG
+	FRandomStream RandomStream;
+
+	// Pose of each ModifyBone in component space, gathered once per frame. Dummy bones extend their parent by
+	// DummyBoneLength. Followed by the DrivingBones of limits which are not ModifyBones
+	TArray<FTransform> BoneTransformsCS;
+
+	// Compact pose index of each entry of BoneTransformsCS (INDEX_NONE for dummy and missing bones),
+	// resolved when the bone container or the bones/limits change
+	TArray<FCompactPoseBoneIndex> PoseGatherIndices;
+	uint16 PoseGatherBoneContainerSerial = 0;
+	int32 PoseGatherNumLimits = 0;
+	bool bPoseGatherDirty = true;
+
+	// MergedBoneConstraints used by the simulation, built in InitBoneConstraints
+	TArray<FKawaiiPhysicsBoneConstraintRuntime> RuntimeBoneConstraints;
+
+	// Colliders of LimitsDataAsset shared with the other nodes of the AnimInstance (bShareLimitsDataAsset)
+	TSharedPtr<FKawaiiPhysicsColliderSet> SharedColliders;
+
+	// State of the LimitsDataAsset colliders when they are not shared, parallel to the asset's limits
+	TArray<FKawaiiPhysicsLimitInstance> SphericalLimitsDataInstances;
+	TArray<FKawaiiPhysicsLimitInstance> CapsuleLimitsDataInstances;
+	TArray<FKawaiiPhysicsLimitInstance> PlanarLimitsDataInstances;
+
+	// UKawaiiPhysicsLimitsDataAsset::GetRevision the *LimitsDataInstances were sized for, 0 if none
+	uint32 AppliedLimitsDataAssetRevision = 0;
+
+	// Self collision : chain (child of the root bone) of each ModifyBone, and the spatial hash scratch buffers
+	TArray<int32> SelfCollisionChains;
+	TArray<int32> SelfCollisionCellStarts;
+	TArray<int32> SelfCollisionSortedBones;
+	TArray<uint32> SelfCollisionBoneCells;
+
+	// PhysicsAsset the *LimitsPhysicsAsset were built from (bUsePhysicsAssetAsLimits)
+	TWeakObjectPtr<const UPhysicsAsset> LimitsPhysicsAsset;
+	// Mesh, RootBone and ignore lists they were filtered with
+	uint32 LimitsPhysicsAssetFilterHash = 0;
+
+	// ModifyBones written to the pose, in compact pose order (dummy and LOD-stripped bones excluded)
+	TArray<int32> OutputBoneOrder;
+	TArray<FCompactPoseBoneIndex> OutputCompactPoseIndices;
+	// Slot of each ModifyBone in OutBoneTransforms, INDEX_NONE if it is not written
+	TArray<int32> OutputBoneSlots;
+	uint16 OutputBoneContainerSerial = 0;
+
+	FKawaiiPhysicsGameThreadInput GameThreadInput;
+
+	// Last frame written to SimulationCache, INDEX_NONE before the recording starts
+	int32 LastRecordedCacheFrame = INDEX_NONE;
+
+	// RestoreState decodes the bones here and commits them only once the whole state is validated
+	TArray<FVector3f> StateScratchLocations;
+	TArray<FVector3f> StateScratchPrevLocations;
+	TArray<FQuat4f> StateScratchPrevRotations;
+	TArray<uint8> StateScratchForceState;
+
 public:
 	FAnimNode_KawaiiPhysics();
 
@@ -720,14 +951,72 @@ public:
 
 	// End of FAnimNode_SkeletalControlBase interface
 
+	/**
+	* 外力とカスタム外力のPreApplyを実行。PreUpdateからゲームスレッドで呼ばれる
+	* Run PreApply of the external forces and the custom external forces. Called on the game thread from PreUpdate,
+	* before this frame's DeltaTime is known
+	*/
+	void PreApplyExternalForces(const USkeletalMeshComponent* SkelComp);
+
 	// For AnimGraphNode
 	float GetTotalBoneLength() const
 	{
 		return TotalBoneLength;
 	}
 
+	TConstArrayView<int32> GetChildIndices(const FKawaiiPhysicsModifyBone& Bone) const
+	{
+		return TConstArrayView<int32>(ModifyBoneChildIndices.GetData() + Bone.FirstChildIndex, Bone.NumChildren);
+	}
+
+	void GetMemoryUsage(FKawaiiPhysicsMemoryUsage& OutUsage) const;
+
+	// For ExternalForce
+	const FRandomStream& GetRandomStream() const
+	{
+		return RandomStream;
+	}
+
+	/**
+	* ボーンの位置・前フレームの位置/回転、外力のタイマーなどシミュレーションの状態を保存。ロールバックやリプレイ用
+	* Save the simulation state (bone Location/PrevLocation/PrevRotation, external force timers, random stream)
+	* for rollback and replays. bQuantize packs each bone in 18 bytes instead of 40
+	*/
+	void SaveState(TArray<uint8>& OutState, bool bQuantize = false) const;
+
+	/**
+	* Restore a state saved by SaveState. Fails and keeps the current state if the bones or the external force types
+	* do not match, or if the state is truncated or corrupted
+	*/
+	bool RestoreState(const TArray<uint8>& State);
+
+	const FKawaiiPhysicsGameThreadInput& GetGameThreadInput() const
+	{
+		return GameThreadInput;
+	}
+
+	const FTransform& GetBoneTransformCS(int32 ModifyBoneIndex) const
+	{
+		return BoneTransformsCS.IsValidIndex(ModifyBoneIndex) ? BoneTransformsCS[ModifyBoneIndex] : FTransform::Identity;
+	}
+
+	FVector3f GetPoseLocation(int32 ModifyBoneIndex) const
+	{
+		return FVector3f(BoneTransformsCS[ModifyBoneIndex].GetLocation());
+	}
+
+	FQuat4f GetPoseRotation(int32 ModifyBoneIndex) const
+	{
+		return FQuat4f(BoneTransformsCS[ModifyBoneIndex].GetRotation());
+	}
+
+	FName GetModifyBoneName(int32 ModifyBoneIndex) const
+	{
+		return ModifyBoneRefs.IsValidIndex(ModifyBoneIndex) ? ModifyBoneRefs[ModifyBoneIndex].BoneName : NAME_None;
+	}
+
 protected:
-	FVector GetBoneForwardVector(const FQuat& Rotation) const
+	FVector3f GetBoneForwardVector(const FQuat4f& Rotation) const
 	{
 		switch (BoneForwardAxis)
 		{
@@ -753,8 +1042,9 @@ protected:
 
 	// Initialize
 	void InitModifyBones(FComponentSpacePoseContext& Output, const FBoneContainer& BoneContainer);
-	void InitBoneConstraints();
-	void ApplyLimitsDataAsset(const FBoneContainer& RequiredBones);
+	void InitBoneConstraints(const FBoneContainer& BoneContainer);
+	void InitExternalForces();
+	void ApplyLimitsDataAsset();
 	void ApplyBoneConstraintDataAsset(const FBoneContainer& RequiredBones);
 	int32 AddModifyBone(FComponentSpacePoseContext& Output, const FBoneContainer& BoneContainer,
 	                    const FReferenceSkeleton& RefSkeleton, int32 BoneIndex);
@@ -762,42 +1052,93 @@ protected:
 	// clone from FReferenceSkeleton::GetDirectChildBones
 	int32 CollectChildBones(const FReferenceSkeleton& RefSkeleton, int32 ParentBoneIndex,
 	                        TArray<int32>& Children) const;
+	void InitChildIndices();
 	void CalcBoneLength(FKawaiiPhysicsModifyBone& Bone, const TArray<FTransform>& RefBonePose);
 
 	// Updates for simulate
 	void UpdatePhysicsSettingsOfModifyBones();
-	void UpdateSphericalLimits(TArray<FSphericalLimit>& Limits, FComponentSpacePoseContext& Output,
-	                           const FBoneContainer& BoneContainer, const FTransform& ComponentTransform);
-	void UpdateCapsuleLimits(TArray<FCapsuleLimit>& Limits, FComponentSpacePoseContext& Output,
-	                         const FBoneContainer& BoneContainer, const FTransform& ComponentTransform);
-	void UpdatePlanerLimits(TArray<FPlanarLimit>& Limits, FComponentSpacePoseContext& Output,
-	                        const FBoneContainer& BoneContainer, const FTransform& ComponentTransform);
-	void UpdateModifyBonesPoseTransform(FComponentSpacePoseContext& Output, const FBoneContainer& BoneContainer);
+	void UpdateSharedColliders(FComponentSpacePoseContext& Output);
+	void UpdatePhysicsAssetLimits(const USkeletalMeshComponent* SkelComp);
+
+public:
+	/**
+	* LimitsDataAssetのコリジョン：アセットの定義と、このノード（または共有）の状態。同じインデックスで対応します
+	* Colliders of LimitsDataAsset : the asset's definitions and this node's (or the shared) state, index for index.
+	* Iterate up to the smaller of the two, they only differ for the evaluation in which the asset changed
+	*/
+	TConstArrayView<FSphericalLimit> GetSphericalLimitsDataDefinitions() const;
+	TConstArrayView<FCapsuleLimit> GetCapsuleLimitsDataDefinitions() const;
+	TConstArrayView<FPlanarLimit> GetPlanarLimitsDataDefinitions() const;
+	TConstArrayView<FKawaiiPhysicsLimitInstance> GetSphericalLimitsDataInstances() const;
+	TConstArrayView<FKawaiiPhysicsLimitInstance> GetCapsuleLimitsDataInstances() const;
+	TConstArrayView<FKawaiiPhysicsLimitInstance> GetPlanarLimitsDataInstances() const;
+
+	// Limits read the DrivingBone transform at their PoseGatherSlot of BoneTransforms
+	static void UpdateSphericalLimits(TArray<FSphericalLimit>& Limits, const TArray<FTransform>& BoneTransforms);
+	static void UpdateCapsuleLimits(TArray<FCapsuleLimit>& Limits, const TArray<FTransform>& BoneTransforms);
+	static void UpdatePlanerLimits(TArray<FPlanarLimit>& Limits, const TArray<FTransform>& BoneTransforms);
+	static void UpdateSphericalLimits(TConstArrayView<FSphericalLimit> Definitions,
+	                                  TArrayView<FKawaiiPhysicsLimitInstance> Instances,
+	                                  const TArray<FTransform>& BoneTransforms);
+	static void UpdateCapsuleLimits(TConstArrayView<FCapsuleLimit> Definitions,
+	                                TArrayView<FKawaiiPhysicsLimitInstance> Instances,
+	                                const TArray<FTransform>& BoneTransforms);
+	static void UpdatePlanerLimits(TConstArrayView<FPlanarLimit> Definitions,
+	                               TArrayView<FKawaiiPhysicsLimitInstance> Instances,
+	                               const TArray<FTransform>& BoneTransforms);
+
+protected:
+	void InitPoseGather(const FBoneContainer& BoneContainer);
+	void GatherPoseTransforms(FComponentSpacePoseContext& Output, const FBoneContainer& BoneContainer);
+	void UpdateModifyBonesPoseTransform();
 	void UpdateSkelCompMove(const FTransform& ComponentTransform);
 
 	// Simulate
 	void SimulateModifyBones(FComponentSpacePoseContext& Output,
 	                         const FTransform& ComponentTransform);
-	void Simulate(FKawaiiPhysicsModifyBone& Bone, const FSceneInterface* Scene, const FTransform& ComponentTransform,
-	              const FVector& GravityCS, const float& Exponent, const USkeletalMeshComponent* SkelComp,
-	              FComponentSpacePoseContext& Output);
-	void AdjustByWorldCollision(FKawaiiPhysicsModifyBone& Bone, const USkeletalMeshComponent* OwningComp);
+	void Simulate(FKawaiiPhysicsModifyBone& Bone, const FVector3f& GravityCS);
+	void AdjustByWorldCollision(FKawaiiPhysicsModifyBone& Bone);
 	void AdjustBySphereCollision(FKawaiiPhysicsModifyBone& Bone, TArray<FSphericalLimit>& Limits);
 	void AdjustByCapsuleCollision(FKawaiiPhysicsModifyBone& Bone, TArray<FCapsuleLimit>& Limits);
 	void AdjustByPlanerCollision(FKawaiiPhysicsModifyBone& Bone, TArray<FPlanarLimit>& Limits);
+	void AdjustBySphereCollision(FKawaiiPhysicsModifyBone& Bone, TConstArrayView<FSphericalLimit> Definitions,
+	                             TConstArrayView<FKawaiiPhysicsLimitInstance> Instances);
+	void AdjustByCapsuleCollision(FKawaiiPhysicsModifyBone& Bone, TConstArrayView<FCapsuleLimit> Definitions,
+	                              TConstArrayView<FKawaiiPhysicsLimitInstance> Instances);
+	void AdjustByPlanerCollision(FKawaiiPhysicsModifyBone& Bone, TConstArrayView<FKawaiiPhysicsLimitInstance> Instances);
 	void AdjustByAngleLimit(
 		FKawaiiPhysicsModifyBone& Bone,
 		const FKawaiiPhysicsModifyBone& ParentBone);
 	void AdjustByPlanarConstraint(FKawaiiPhysicsModifyBone& Bone, const FKawaiiPhysicsModifyBone& ParentBone);
+	void UpdateBoneConstraintCompliance();
 	void AdjustByBoneConstraints();
-
+	void AdjustBySelfCollision();
+	void AdjustSegmentBySphereCollision(FKawaiiPhysicsModifyBone& Bone, FKawaiiPhysicsModifyBone& ParentBone,
+	                                    const TArray<FSphericalLimit>& Limits);
+	void AdjustSegmentByCapsuleCollision(FKawaiiPhysicsModifyBone& Bone, FKawaiiPhysicsModifyBone& ParentBone,
+	                                     const TArray<FCapsuleLimit>& Limits);
+	void AdjustSegmentBySphereCollision(FKawaiiPhysicsModifyBone& Bone, FKawaiiPhysicsModifyBone& ParentBone,
+	                                    TConstArrayView<FSphericalLimit> Definitions,
+	                                    TConstArrayView<FKawaiiPhysicsLimitInstance> Instances);
+	void AdjustSegmentByCapsuleCollision(FKawaiiPhysicsModifyBone& Bone, FKawaiiPhysicsModifyBone& ParentBone,
+	                                     TConstArrayView<FCapsuleLimit> Definitions,
+	                                     TConstArrayView<FKawaiiPhysicsLimitInstance> Instances);
+
+	void InitOutputBoneOrder(const FBoneContainer& BoneContainer);
 	void ApplySimulateResult(FComponentSpacePoseContext& Output, const FBoneContainer& BoneContainer,
 	                         TArray<FBoneTransform>& OutBoneTransforms);
+	void ReadBonesState(FArchive& Ar, bool bQuantized);
+	bool ValidateForcesState(FArchive& Ar);
+	bool PlaybackSimulationCache();
+	int32 BeginSimulationCacheFrame();
+	void RecordSimulationCacheFrames(FComponentSpacePoseContext& Output, const FTransform& ComponentTransform,
+	                                 int32 FirstFrame);
 	void WarmUp(FComponentSpacePoseContext& Output, const FBoneContainer& BoneContainer,
 	            FTransform& ComponentTransform);
 
-	FVector GetWindVelocity(const FSceneInterface* Scene, const FTransform& ComponentTransform,
-	                        const FKawaiiPhysicsModifyBone& Bone) const;
+	void SampleWind(const FSceneInterface* Scene, const FTransform& ComponentTransform);
+	void UpdateGameThreadInput(const USkeletalMeshComponent* SkelComp);
+	FVector3f GetWindVelocity(const FKawaiiPhysicsModifyBone& Bone) const;
 
 #if ENABLE_ANIM_DEBUG
 	void AnimDrawDebug(const FComponentSpacePoseContext& Output);
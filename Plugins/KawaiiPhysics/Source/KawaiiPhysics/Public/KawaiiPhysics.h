@@ -3,10 +3,14 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
 #include "Modules/ModuleInterface.h"
 
 DECLARE_LOG_CATEGORY_EXTERN(LogKawaiiPhysics, Log, All);
 
+// Allocations of the KawaiiPhysics nodes (bones, colliders, constraints, forces, caches) in LLM reports
+LLM_DECLARE_TAG_API(KawaiiPhysics, KAWAIIPHYSICS_API);
+
 class FKawaiiPhysicsModule : public IModuleInterface
 {
 public:
@@ -80,6 +80,9 @@ public:
 
 	TArray<FModifyBoneConstraint> GenerateBoneConstraints();
 
+	/** Append the constraints to OutBoneConstraints, without the temporary array of GenerateBoneConstraints */
+	void AppendBoneConstraints(TArray<FModifyBoneConstraint>& OutBoneConstraints) const;
+
 #if WITH_EDITOR
 
 	UFUNCTION(BlueprintCallable, CallInEditor, Category="Helper")
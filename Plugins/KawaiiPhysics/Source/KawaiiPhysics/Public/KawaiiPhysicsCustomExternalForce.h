@@ -1,9 +1,15 @@
 ﻿#pragma once
 #include "AnimNode_KawaiiPhysics.h"
+#include "KawaiiPhysicsExternalForce.h"
 #include "Curves/CurveVector.h"
 #include "KawaiiPhysicsCustomExternalForce.generated.h"
 
 
+/**
+* カスタム外力。PreApplyはゲームスレッドで1フレームに1回、ApplyBatchはワーカースレッドでチェーン全体に1回呼ばれる
+* Custom external force. PreApply runs once per frame on the game thread (BP can compute parameters here),
+* ApplyBatch runs once per frame on the anim worker thread for the whole chain and must be thread-safe.
+*/
 UCLASS(Abstract, Blueprintable, EditInlineNew, CollapseCategories)
 class KAWAIIPHYSICS_API UKawaiiPhysics_CustomExternalForce : public UObject
 {
@@ -16,14 +22,61 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(DisplayPriority=1))
 	bool bDrawDebug = false;
 
+	/**
+	* ApplyBatchで全ボーンに加える力。PreApplyで計算して設定する
+	* Force applied to every bone by the native ApplyBatch. Typically computed in PreApply
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(DisplayPriority=1))
+	FVector ConstantForce = FVector::ZeroVector;
+
+	/**
+	* ConstantForceの座標系
+	* Space of ConstantForce
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(DisplayPriority=1))
+	EExternalForceSpace ExternalForceSpace = EExternalForceSpace::ComponentSpace;
+
 public:
+	virtual void PostInitProperties() override;
+
+	/**
+	* ゲームスレッドから呼ばれる。PreApplyを実行し、ワーカースレッド用のパラメータを確定する
+	* Called from the game thread (FAnimNode_KawaiiPhysics::PreUpdate). Runs PreApply and resolves
+	* the parameters used by ApplyBatch
+	*/
+	void PreUpdate(FAnimNode_KawaiiPhysics& Node, const USkeletalMeshComponent* SkelComp);
+
+	/**
+	* ワーカースレッドから呼ばれる。スレッドセーフであること
+	* Called once per frame from the anim worker thread for the whole chain. Must be thread-safe.
+	* The default implementation adds ConstantForce to every simulated bone, then runs Apply per bone
+	* only for legacy subclasses that still implement it
+	*/
+	virtual void ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones, FAnimNode_KawaiiPhysics& Node,
+	                        const FComponentSpacePoseContext& PoseContext,
+	                        TConstArrayView<FTransform> BoneTransforms);
+
+	/**
+	* ゲームスレッドで1フレームに1回呼ばれる（任意）。Forceなどのパラメータを計算する
+	* Optional. Called once per frame on the game thread before the anim update. Compute parameters such as Force here.
+	* Node.DeltaTime still holds the previous frame's value at this point
+	*/
 	UFUNCTION(BlueprintNativeEvent)
 	void PreApply(UPARAM(ref) FAnimNode_KawaiiPhysics& Node,
 	              const USkeletalMeshComponent* SkelComp);
 
 	virtual void PreApply_Implementation(
-		UPARAM(ref) FAnimNode_KawaiiPhysics& Node, const USkeletalMeshComponent* SkelComp)PURE_VIRTUAL(,);
+		UPARAM(ref) FAnimNode_KawaiiPhysics& Node, const USkeletalMeshComponent* SkelComp)
+	{
+	}
 
+	/**
+	* 非推奨：ワーカースレッドでボーンごとに呼ばれる。BPで実装するとコンパイル時に警告
+	* Deprecated : called per bone on the anim worker thread. Implementing it in Blueprint is not thread-safe
+	* and costs a VM call per bone, and is reported as a warning when the AnimBlueprint is compiled.
+	* Compute parameters in PreApply, or override ApplyBatch in C++ instead.
+	* C++ overrides must not call Super::Apply_Implementation : it is how a class without an override is detected
+	*/
 	UFUNCTION(BlueprintNativeEvent)
 	void Apply(UPARAM(ref) FAnimNode_KawaiiPhysics& Node, int32 ModifyBoneIndex,
 	           const USkeletalMeshComponent* SkelComp, const FTransform& BoneTransform);
@@ -32,6 +85,14 @@ public:
 		UPARAM(ref) FAnimNode_KawaiiPhysics& Node, int32 ModifyBoneIndex, const USkeletalMeshComponent* SkelComp,
 		const FTransform& BoneTransform)
 	{
+		// Not overridden in C++ : ApplyBatch stops calling Apply per bone (see UObject::ImplementsGetWorld)
+		bImplementsNativeApply = false;
+	}
+
+	/** Whether Apply is implemented in Blueprint (per bone VM calls on the worker thread) */
+	bool ImplementsBlueprintApply() const
+	{
+		return bImplementsBlueprintApply;
 	}
 
 	UFUNCTION(BlueprintCallable)
@@ -43,4 +104,16 @@ public:
 		}
 		return false;
 	}
+
+private:
+	// ConstantForce resolved to component space in PreUpdate (BoneSpace is resolved per bone in ApplyBatch)
+	FVector ForceCS = FVector::ZeroVector;
+
+	// Component of the last PreUpdate, only handed to the deprecated per bone Apply
+	const USkeletalMeshComponent* PreUpdateSkelComp = nullptr;
+
+	// Cached in PostInitProperties
+	bool bImplementsBlueprintApply = false;
+	// Assumed until the default Apply_Implementation runs once
+	bool bImplementsNativeApply = true;
 };
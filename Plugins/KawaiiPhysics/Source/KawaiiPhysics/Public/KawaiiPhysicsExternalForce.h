@@ -64,7 +64,9 @@ public:
 	float DebugArrowLength = 5.0f;
 	float DebugArrowSize = 1.0f;
 	FVector DebugArrowOffset = FVector::Zero();
-	TMap<FName, FVector> BoneForceMap;
+
+	// ModifyBone index -> applied force, only recorded while bDrawDebug is on
+	TArray<FVector> DebugBoneForces;
 #endif
 
 protected:
@@ -74,6 +76,13 @@ protected:
 	UPROPERTY()
 	bool bUseExternalForceSpace = true;
 
+	// ModifyBone index -> whether this force applies, resolved from the bone filters when ModifyBones are built
+	TBitArray<> BoneMask;
+	bool bHasApplicableBone = true;
+
+	// ModifyBone index -> ForceRateByBoneLengthRate, baked when ModifyBones are built
+	TArray<float> BoneForceRates;
+
 public:
 	virtual ~FKawaiiPhysics_ExternalForce() = default;
 
@@ -81,6 +90,49 @@ public:
 	{
 	}
 
+	/**
+	* ノードのSaveState/RestoreStateで保存・復元される内部状態（タイマーなど）
+	* Runtime state (timers etc.) saved and restored with FAnimNode_KawaiiPhysics::SaveState/RestoreState.
+	* LoadState reads exactly what SaveState writes, and the size must not depend on the state
+	*/
+	virtual void SaveState(FArchive& Ar) const
+	{
+	}
+
+	virtual void LoadState(FArchive& Ar)
+	{
+	}
+
+	/**
+	* ModifyBonesの構築時に呼ばれる。ボーンごとの適用可否などを事前計算
+	* Called when ModifyBones are (re)built. Resolve per bone data such as the bone filters here
+	*/
+	virtual void InitBones(const FAnimNode_KawaiiPhysics& Node)
+	{
+		const TArray<FKawaiiPhysicsModifyBone>& ModifyBones = Node.ModifyBones;
+		BoneMask.Init(false, ModifyBones.Num());
+		bHasApplicableBone = false;
+		for (const FKawaiiPhysicsModifyBone& Bone : ModifyBones)
+		{
+			if (BoneMask.IsValidIndex(Bone.Index) && Node.ModifyBoneRefs.IsValidIndex(Bone.Index) &&
+				CanApplyByBoneFilter(Node.ModifyBoneRefs[Bone.Index]))
+			{
+				BoneMask[Bone.Index] = true;
+				bHasApplicableBone = true;
+			}
+		}
+	}
+
+	bool HasApplicableBone() const
+	{
+		return bHasApplicableBone;
+	}
+
+	/**
+	* ゲームスレッドで1フレームに1回呼ばれる。ワーカースレッドで使うパラメータを計算する
+	* Called once per frame on the game thread from FAnimNode_KawaiiPhysics::PreUpdate, SkelComp may be null.
+	* Compute the parameters Apply/ApplyBatch read here. Node.DeltaTime still holds the previous frame's value
+	*/
 	virtual void PreApply(FAnimNode_KawaiiPhysics& Node, const USkeletalMeshComponent* SkelComp)
 	{
 	}
@@ -90,6 +142,32 @@ public:
 	{
 	}
 
+	/**
+	* チェーン全体にまとめて外力を適用。デフォルト実装は互換性のためボーンごとにApplyを呼び出す
+	* Apply the force to the whole chain in one call. The default implementation calls Apply per bone for compatibility
+	* @param BoneTransforms Component space transform of each ModifyBone (see FAnimNode_KawaiiPhysics::GetBoneTransformCS)
+	*/
+	virtual void ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones, FAnimNode_KawaiiPhysics& Node,
+	                        const FComponentSpacePoseContext& PoseContext, TConstArrayView<FTransform> BoneTransforms)
+	{
+		for (FKawaiiPhysicsModifyBone& Bone : Bones)
+		{
+			if (Bone.bSkipSimulate)
+			{
+				continue;
+			}
+
+			if (ExternalForceSpace == EExternalForceSpace::BoneSpace)
+			{
+				Apply(Bone, Node, PoseContext, BoneTransforms[Bone.Index]);
+			}
+			else
+			{
+				Apply(Bone, Node, PoseContext);
+			}
+		}
+	}
+
 
 	virtual bool IsDebugEnabled(bool bInPersona = false)
 	{
@@ -98,28 +176,61 @@ public:
 			return bDrawDebug && bIsEnabled;
 		}
 
-		if (const auto CVar = IConsoleManager::Get().FindConsoleVariable(TEXT("a.AnimNode.KawaiiPhysics.Debug")))
+		if (!bDrawDebug || !bIsEnabled)
 		{
-			return CVar->GetBool() && bDrawDebug && bIsEnabled;
+			return false;
 		}
-		return false;
+
+		static const IConsoleVariable* CVar = IConsoleManager::Get().FindConsoleVariable(
+			TEXT("a.AnimNode.KawaiiPhysics.Debug"));
+		return CVar && CVar->GetBool();
 	}
 
 #if ENABLE_ANIM_DEBUG
+	/**
+	* デバッグ表示用に外力を記録するか。bDrawDebugが無効なら記録しない
+	* Whether applied forces should be recorded for debug drawing (runtime or edit mode)
+	*/
+	bool ShouldRecordDebugForce() const
+	{
+		return bDrawDebug && bIsEnabled;
+	}
+
+	void RecordDebugForce(const FAnimNode_KawaiiPhysics& Node, int32 ModifyBoneIndex, const FVector& BoneForce)
+	{
+		if (DebugBoneForces.Num() != Node.ModifyBones.Num())
+		{
+			DebugBoneForces.SetNumZeroed(Node.ModifyBones.Num());
+		}
+		if (DebugBoneForces.IsValidIndex(ModifyBoneIndex))
+		{
+			DebugBoneForces[ModifyBoneIndex] = BoneForce;
+		}
+	}
+
+	const FVector* FindDebugForce(int32 ModifyBoneIndex) const
+	{
+		return DebugBoneForces.IsValidIndex(ModifyBoneIndex) ? &DebugBoneForces[ModifyBoneIndex] : nullptr;
+	}
+
 	virtual void AnimDrawDebug(FKawaiiPhysicsModifyBone& Bone, FAnimNode_KawaiiPhysics& Node,
 	                           const FComponentSpacePoseContext& PoseContext)
 	{
 		if (IsDebugEnabled() && !Force.IsZero())
 		{
+			const FVector* BoneForce = FindDebugForce(Bone.Index);
+			if (!BoneForce)
+			{
+				return;
+			}
+
 			const auto AnimInstanceProxy = PoseContext.AnimInstanceProxy;
 			const FVector ModifyRootBoneLocationWS = AnimInstanceProxy->GetComponentTransform().TransformPosition(
-				Bone.Location);
+				FVector(Bone.Location));
 
 			AnimInstanceProxy->AnimDrawDebugDirectionalArrow(
 				ModifyRootBoneLocationWS + DebugArrowOffset,
-				ModifyRootBoneLocationWS + DebugArrowOffset + BoneForceMap.Find(Bone.BoneRef.BoneName)->GetSafeNormal()
-				*
-				DebugArrowLength,
+				ModifyRootBoneLocationWS + DebugArrowOffset + BoneForce->GetSafeNormal() * DebugArrowLength,
 				DebugArrowSize, FColor::Red, false, 0.f, 2);
 		}
 	}
@@ -129,12 +240,11 @@ public:
 	virtual void AnimDrawDebugForEditMode(const FKawaiiPhysicsModifyBone& ModifyBone,
 	                                      const FAnimNode_KawaiiPhysics& Node, FPrimitiveDrawInterface* PDI)
 	{
-		if (IsDebugEnabled(true) && CanApply(ModifyBone) && !Force.IsNearlyZero() && BoneForceMap.Contains(
-			ModifyBone.BoneRef.BoneName))
+		const FVector* BoneForce = FindDebugForce(ModifyBone.Index);
+		if (IsDebugEnabled(true) && CanApply(ModifyBone) && !Force.IsNearlyZero() && BoneForce)
 		{
-			const FTransform ArrowTransform = FTransform(
-				BoneForceMap.Find(ModifyBone.BoneRef.BoneName)->GetSafeNormal().ToOrientationRotator(),
-				ModifyBone.Location + DebugArrowOffset);
+			const FTransform ArrowTransform = FTransform(BoneForce->GetSafeNormal().ToOrientationRotator(),
+			                                             FVector(ModifyBone.Location) + DebugArrowOffset);
 			DrawDirectionalArrow(PDI, ArrowTransform.ToMatrixNoScale(), FColor::Red, DebugArrowLength, DebugArrowSize,
 			                     SDPG_Foreground, 1.0f);
 		}
@@ -142,14 +252,66 @@ public:
 #endif
 
 protected:
+	float GetRandomForceScale(const FAnimNode_KawaiiPhysics& Node) const
+	{
+		return Node.GetRandomStream().FRandRange(RandomForceScale.Min, RandomForceScale.Max);
+	}
+
+	static float EvalForceRate(const FRichCurve* Curve, const FKawaiiPhysicsModifyBone& Bone,
+	                           const FAnimNode_KawaiiPhysics& Node)
+	{
+		if (!Curve || Curve->IsEmpty())
+		{
+			return 1.0f;
+		}
+		const float TotalBoneLength = Node.GetTotalBoneLength();
+		return Curve->Eval(TotalBoneLength > 0.0f ? Bone.LengthFromRoot / TotalBoneLength : 0.0f);
+	}
+
+	void BakeForceRates(const FAnimNode_KawaiiPhysics& Node, const FRuntimeFloatCurve& ForceRateCurve)
+	{
+		BoneForceRates.Init(1.0f, Node.ModifyBones.Num());
+		const FRichCurve* Curve = ForceRateCurve.GetRichCurveConst();
+		for (const FKawaiiPhysicsModifyBone& Bone : Node.ModifyBones)
+		{
+			if (BoneForceRates.IsValidIndex(Bone.Index))
+			{
+				BoneForceRates[Bone.Index] = EvalForceRate(Curve, Bone, Node);
+			}
+		}
+	}
+
+	float GetForceRate(const FKawaiiPhysicsModifyBone& Bone, const FAnimNode_KawaiiPhysics& Node,
+	                   const FRuntimeFloatCurve& ForceRateCurve) const
+	{
+		if (BoneForceRates.IsValidIndex(Bone.Index))
+		{
+			return BoneForceRates[Bone.Index];
+		}
+
+		// Not baked yet
+		return EvalForceRate(ForceRateCurve.GetRichCurveConst(), Bone, Node);
+	}
+
 	bool CanApply(const FKawaiiPhysicsModifyBone& Bone) const
 	{
-		if (!ApplyBoneFilter.IsEmpty() && !ApplyBoneFilter.Contains(Bone.BoneRef))
+		if (BoneMask.IsValidIndex(Bone.Index))
+		{
+			return BoneMask[Bone.Index];
+		}
+
+		// Mask is not built yet : the bone filters need the bones of the node
+		return ApplyBoneFilter.IsEmpty() && IgnoreBoneFilter.IsEmpty();
+	}
+
+	bool CanApplyByBoneFilter(const FBoneReference& BoneRef) const
+	{
+		if (!ApplyBoneFilter.IsEmpty() && !ApplyBoneFilter.Contains(BoneRef))
 		{
 			return false;
 		}
 
-		if (!IgnoreBoneFilter.IsEmpty() && IgnoreBoneFilter.Contains(Bone.BoneRef))
+		if (!IgnoreBoneFilter.IsEmpty() && IgnoreBoneFilter.Contains(BoneRef))
 		{
 			return false;
 		}
@@ -183,10 +345,26 @@ public:
 	float Interval = 0.0f;
 
 public:
+	virtual void InitBones(const FAnimNode_KawaiiPhysics& Node) override;
 	virtual void PreApply(FAnimNode_KawaiiPhysics& Node, const USkeletalMeshComponent* SkelComp) override;
 	virtual void Apply(FKawaiiPhysicsModifyBone& Bone, FAnimNode_KawaiiPhysics& Node,
 	                   const FComponentSpacePoseContext& PoseContext,
 	                   const FTransform& BoneTM = FTransform::Identity) override;
+	virtual void ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones, FAnimNode_KawaiiPhysics& Node,
+	                        const FComponentSpacePoseContext& PoseContext,
+	                        TConstArrayView<FTransform> BoneTransforms) override;
+
+	virtual void SaveState(FArchive& Ar) const override
+	{
+		float StateTime = Time;
+		float StatePrevTime = PrevTime;
+		Ar << StateTime << StatePrevTime;
+	}
+
+	virtual void LoadState(FArchive& Ar) override
+	{
+		Ar << Time << PrevTime;
+	}
 
 private:
 	UPROPERTY()
@@ -243,10 +421,14 @@ public:
 private:
 
 public:
+	virtual void InitBones(const FAnimNode_KawaiiPhysics& Node) override;
 	virtual void PreApply(FAnimNode_KawaiiPhysics& Node, const USkeletalMeshComponent* SkelComp) override;
 	virtual void Apply(FKawaiiPhysicsModifyBone& Bone, FAnimNode_KawaiiPhysics& Node,
 	                   const FComponentSpacePoseContext& PoseContext,
 	                   const FTransform& BoneTM = FTransform::Identity) override;
+	virtual void ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones, FAnimNode_KawaiiPhysics& Node,
+	                        const FComponentSpacePoseContext& PoseContext,
+	                        TConstArrayView<FTransform> BoneTransforms) override;
 };
 
 ///
@@ -287,6 +469,14 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float TimeScale = 1.0f;
 
+	/** 
+	* ForceCurveを事前にサンプリングする際の1秒あたりのサンプル数。0の場合は毎回カーブを評価
+	* Samples per second used to pre-sample ForceCurve for substep evaluation. 0 evaluates the curve every time
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay,
+		meta=(ClampMin="0", EditCondition="CurveEvaluateType!=EExternalForceCurveEvaluateType::Single"))
+	int32 CurveSampleRate = 120;
+
 	/** 
 	* 各ボーンに適用するForce Rateを補正。
 	* 「RootBoneから特定のボーンまでの長さ / RootBoneから末端のボーンまでの長さ」(0.0~1.0)の値におけるカーブの値をForceRateに乗算
@@ -304,12 +494,36 @@ private:
 	UPROPERTY()
 	float MaxCurveTime = 0.0f;
 
+	// ForceCurve sampled at a fixed interval over [0, MaxCurveTime]
+	TArray<FVector> CurveTable;
+	float CurveTableInterval = 0.0f;
+	bool bCurveTableBuilt = false;
+
+	FVector SampleCurveTable(float InTime) const;
+
 public:
 	void InitMaxCurveTime();
+	void InitCurveTable();
 
 	virtual void Initialize(const FAnimationInitializeContext& Context) override;
+	virtual void InitBones(const FAnimNode_KawaiiPhysics& Node) override;
 	virtual void PreApply(FAnimNode_KawaiiPhysics& Node, const USkeletalMeshComponent* SkelComp) override;
 	virtual void Apply(FKawaiiPhysicsModifyBone& Bone, FAnimNode_KawaiiPhysics& Node,
 	                   const FComponentSpacePoseContext& PoseContext,
 	                   const FTransform& BoneTM = FTransform::Identity) override;
+	virtual void ApplyBatch(TArrayView<FKawaiiPhysicsModifyBone> Bones, FAnimNode_KawaiiPhysics& Node,
+	                        const FComponentSpacePoseContext& PoseContext,
+	                        TConstArrayView<FTransform> BoneTransforms) override;
+
+	virtual void SaveState(FArchive& Ar) const override
+	{
+		float StateTime = Time;
+		float StatePrevTime = PrevTime;
+		Ar << StateTime << StatePrevTime;
+	}
+
+	virtual void LoadState(FArchive& Ar) override
+	{
+		Ar << Time << PrevTime;
+	}
 };
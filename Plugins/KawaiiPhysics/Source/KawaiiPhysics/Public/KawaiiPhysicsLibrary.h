@@ -76,6 +76,15 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
 	static FKawaiiPhysicsReference ResetDynamics(const FKawaiiPhysicsReference& KawaiiPhysics);
 
+	/** Save the simulation state (rollback / replay) */
+	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static FKawaiiPhysicsReference SaveState(const FKawaiiPhysicsReference& KawaiiPhysics, TArray<uint8>& State,
+	                                         bool bQuantize = false);
+	/** Restore a simulation state saved by SaveState */
+	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static FKawaiiPhysicsReference RestoreState(const FKawaiiPhysicsReference& KawaiiPhysics, const TArray<uint8>& State,
+	                                            bool& bSuccess);
+
 	/** Set RootBone */
 	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
 	static FKawaiiPhysicsReference SetRootBoneName(const FKawaiiPhysicsReference& KawaiiPhysics,
@@ -230,6 +239,34 @@ public:
 		KAWAIIPHYSICS_VALUE_GETTER(TObjectPtr<UKawaiiPhysicsLimitsDataAsset>, LimitsDataAsset);
 	}
 
+	/** SimulationCacheMode */
+	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static FKawaiiPhysicsReference SetSimulationCacheMode(const FKawaiiPhysicsReference& KawaiiPhysics,
+	                                                      EKawaiiPhysicsSimulationCacheMode SimulationCacheMode)
+	{
+		KAWAIIPHYSICS_VALUE_SETTER(EKawaiiPhysicsSimulationCacheMode, SimulationCacheMode);
+	}
+
+	UFUNCTION(BlueprintPure, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static EKawaiiPhysicsSimulationCacheMode GetSimulationCacheMode(const FKawaiiPhysicsReference& KawaiiPhysics)
+	{
+		KAWAIIPHYSICS_VALUE_GETTER(EKawaiiPhysicsSimulationCacheMode, SimulationCacheMode);
+	}
+
+	/** SimulationCacheTime */
+	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static FKawaiiPhysicsReference SetSimulationCacheTime(const FKawaiiPhysicsReference& KawaiiPhysics,
+	                                                      float SimulationCacheTime)
+	{
+		KAWAIIPHYSICS_VALUE_SETTER(float, SimulationCacheTime);
+	}
+
+	UFUNCTION(BlueprintPure, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static float GetSimulationCacheTime(const FKawaiiPhysicsReference& KawaiiPhysics)
+	{
+		KAWAIIPHYSICS_VALUE_GETTER(float, SimulationCacheTime);
+	}
+
 
 	/** Set ExternalForceParameter template */
 	template <typename ValueType, typename PropertyType>
@@ -412,6 +449,51 @@ public:
 		checkNoEntry();
 	}
 
+	/**
+	 * ModifyBoneの現在位置を取得（ソルバーは単精度で保持している）
+	 * Get the simulated location of a modify bone. The solver keeps it in single precision.
+	 */
+	UFUNCTION(BlueprintPure, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static FVector GetModifyBoneLocation(const FKawaiiPhysicsModifyBone& ModifyBone)
+	{
+		return FVector(ModifyBone.Location);
+	}
+
+	/** Set the simulated location of a modify bone */
+	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static void SetModifyBoneLocation(UPARAM(ref) FKawaiiPhysicsModifyBone& ModifyBone, FVector Location)
+	{
+		ModifyBone.Location = FVector3f(Location);
+	}
+
+	/** Get the location of a modify bone in the previous simulation step */
+	UFUNCTION(BlueprintPure, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static FVector GetModifyBonePrevLocation(const FKawaiiPhysicsModifyBone& ModifyBone)
+	{
+		return FVector(ModifyBone.PrevLocation);
+	}
+
+	/** Get the input pose transform of a modify bone in component space */
+	UFUNCTION(BlueprintPure, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static FTransform GetModifyBonePoseTransform(const FAnimNode_KawaiiPhysics& Node,
+	                                             const FKawaiiPhysicsModifyBone& ModifyBone)
+	{
+		return Node.GetBoneTransformCS(ModifyBone.Index);
+	}
+
+	/** Get the indices of the children of a modify bone in ModifyBones */
+	UFUNCTION(BlueprintPure, Category = "Kawaii Physics", meta=(BlueprintThreadSafe))
+	static TArray<int32> GetModifyBoneChildIndices(const FAnimNode_KawaiiPhysics& Node,
+	                                               const FKawaiiPhysicsModifyBone& ModifyBone)
+	{
+		// Read the node's own bone : a copy made in Blueprint may not match ModifyBoneChildIndices any more
+		if (!Node.ModifyBones.IsValidIndex(ModifyBone.Index))
+		{
+			return TArray<int32>();
+		}
+		return TArray<int32>(Node.GetChildIndices(Node.ModifyBones[ModifyBone.Index]));
+	}
+
 private:
 	DECLARE_FUNCTION(execSetExternalForceWildcardProperty);
 	DECLARE_FUNCTION(execGetExternalForceWildcardProperty);
@@ -43,8 +43,8 @@ protected:
 		DrivingBoneReference = FBoneReference(Limit->DrivingBone.BoneName);
 		OffsetLocation = Limit->OffsetLocation;
 		OffsetRotation = Limit->OffsetRotation;
-		Location = Limit->Location;
-		Rotation = Limit->Rotation;
+		Location = FVector(Limit->Location);
+		Rotation = FQuat(Limit->Rotation);
 	}
 
 	void ConvertBase(FCollisionLimitBase& Limit) const
@@ -52,8 +52,9 @@ protected:
 		Limit.DrivingBone.BoneName = DrivingBoneReference.BoneName;
 		Limit.OffsetLocation = OffsetLocation;
 		Limit.OffsetRotation = OffsetRotation;
-		Limit.Location = Location;
-		Limit.Rotation = Rotation;
+		Limit.Location = FVector3f(Location);
+		Limit.Rotation = FQuat4f(Rotation);
+		Limit.OffsetTransform = FTransform(OffsetRotation, OffsetLocation);
 
 #if  WITH_EDITORONLY_DATA
 		Limit.bFromDataAsset = true;
@@ -133,14 +134,14 @@ struct FPlanarLimitData : public FCollisionLimitDataBase
 	void Update(const FPlanarLimit* Limit)
 	{
 		UpdateBase(Limit);
-		Plane = Limit->Plane;
+		Plane = FPlane(Limit->Plane);
 	}
 
 	FPlanarLimit Convert() const
 	{
 		FPlanarLimit Limit;
 		ConvertBase(Limit);
-		Limit.Plane = Plane;
+		Limit.Plane = FPlane4f(Plane);
 
 		return Limit;
 	}
@@ -181,9 +182,16 @@ public:
 #if WITH_EDITORONLY_DATA
 	virtual void Serialize(FStructuredArchiveRecord Record) override;
 #endif
+	virtual void PostInitProperties() override;
 	virtual void PostLoad() override;
 	// End UObject Interface.
 
+	/** Changes with the limits and is unique over all assets : nodes resize their per node state only when it changes */
+	uint32 GetRevision() const
+	{
+		return Revision;
+	}
+
 #if WITH_EDITOR
 
 	void UpdateLimit(FCollisionLimitBase* Limit);
@@ -198,4 +206,12 @@ public:
 	FOnLimitsChanged OnLimitsChanged;
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
+
+private:
+	void UpdateRevision();
+
+	// OffsetTransform is not serialized : nodes read it from the asset in place
+	void UpdateOffsetTransforms();
+
+	uint32 Revision = 0;
 };
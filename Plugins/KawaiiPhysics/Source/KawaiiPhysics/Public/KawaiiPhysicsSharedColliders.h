@@ -0,0 +1,63 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimNode_KawaiiPhysics.h"
+
+struct FAnimInstanceProxy;
+class UPhysicsAsset;
+
+/**
+* 同じAnimInstanceのKawaiiPhysicsノード間で共有するLimitsDataAssetのコリジョン。1回の評価につき1度だけ更新される
+* Colliders of a LimitsDataAsset shared by every KawaiiPhysics node of one AnimInstance.
+* The first node evaluated updates them, the following nodes of the same evaluation only read them.
+* The limits are read from the asset, only their per AnimInstance state is kept here.
+*/
+struct KAWAIIPHYSICS_API FKawaiiPhysicsColliderSet
+{
+	// Index for index with the asset's SphericalLimits/CapsuleLimits/PlanarLimits
+	TArray<FKawaiiPhysicsLimitInstance> SphericalLimitInstances;
+	TArray<FKawaiiPhysicsLimitInstance> CapsuleLimitInstances;
+	TArray<FKawaiiPhysicsLimitInstance> PlanarLimitInstances;
+
+	/** Find the set of LimitsDataAsset for the AnimInstance, or create it */
+	static TSharedPtr<FKawaiiPhysicsColliderSet> FindOrAdd(const FAnimInstanceProxy* AnimInstanceProxy,
+	                                                       const UKawaiiPhysicsLimitsDataAsset* LimitsDataAsset);
+
+	/** Update the colliders from the pose unless it was already done in this evaluation */
+	void Update(FComponentSpacePoseContext& Output);
+
+	const UKawaiiPhysicsLimitsDataAsset* GetLimitsDataAsset() const { return LimitsDataAsset.Get(); }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return SphericalLimitInstances.GetAllocatedSize() + CapsuleLimitInstances.GetAllocatedSize()
+			+ PlanarLimitInstances.GetAllocatedSize() + PoseGatherIndices.GetAllocatedSize() + BoneTransformsCS.GetAllocatedSize();
+	}
+
+private:
+	void InitPoseGather(const FBoneContainer& BoneContainer);
+
+	TWeakObjectPtr<const UKawaiiPhysicsLimitsDataAsset> LimitsDataAsset;
+	// UKawaiiPhysicsLimitsDataAsset::GetRevision of the limits the instances were built for in InitPoseGather
+	uint32 AppliedRevision = 0;
+
+	TArray<FCompactPoseBoneIndex> PoseGatherIndices;
+	TArray<FTransform> BoneTransformsCS;
+	const FBoneContainer* PoseGatherBoneContainer = nullptr;
+	uint16 PoseGatherBoneContainerSerial = 0;
+
+	FGraphTraversalCounter EvaluationCounter;
+};
+
+/**
+* PhysicsAssetの球・カプセルボディをLimitに変換したもの。PhysicsAssetごとにキャッシュされる
+* Sphere and sphyl bodies of a PhysicsAsset converted to limits, cached per PhysicsAsset
+*/
+struct KAWAIIPHYSICS_API FKawaiiPhysicsPhysicsAssetLimits
+{
+	TArray<FSphericalLimit> SphericalLimits;
+	TArray<FCapsuleLimit> CapsuleLimits;
+
+	/** Find the converted limits of PhysicsAsset, or convert them. Game thread only */
+	static TSharedPtr<const FKawaiiPhysicsPhysicsAssetLimits> FindOrAdd(const UPhysicsAsset* PhysicsAsset);
+};
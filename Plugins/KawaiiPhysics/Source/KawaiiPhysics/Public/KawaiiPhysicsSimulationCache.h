@@ -0,0 +1,128 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "KawaiiPhysicsSimulationCache.generated.h"
+
+struct FKawaiiPhysicsModifyBone;
+
+UENUM(BlueprintType)
+enum class EKawaiiPhysicsSimulationCacheMode : uint8
+{
+	None UMETA(DisplayName = "None"),
+	Record UMETA(DisplayName = "Record"),
+	Playback UMETA(DisplayName = "Playback"),
+};
+
+/** Full precision simulation state of one frame to resume the simulation from */
+USTRUCT()
+struct FKawaiiPhysicsSimulationCacheKeyframe
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	int32 Frame = 0;
+
+	UPROPERTY()
+	TArray<FVector3f> Locations;
+
+	UPROPERTY()
+	TArray<FVector3f> PrevLocations;
+
+	// Time step that led to this frame, the simulation's velocity is (Location - PrevLocation) / DeltaTime
+	UPROPERTY()
+	float DeltaTime = 0.0f;
+};
+
+/**
+* KawaiiPhysicsノードのシミュレーション結果を記録・再生するキャッシュ。シネマティクスでの再現性と描画コスト削減用
+* Recorded simulation of one KawaiiPhysics node : the component space location of each ModifyBone per frame,
+* quantized to 16 bits per axis inside per bone bounds, plus full precision keyframes to resume recording from.
+* Playback costs a cache read instead of the simulation and gives the same result on every take.
+*/
+UCLASS(BlueprintType)
+class KAWAIIPHYSICS_API UKawaiiPhysicsSimulationCache : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* 記録するフレームレート
+	* Frames per second recorded
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cache", meta = (ClampMin = "1"))
+	float FrameRate = 30.0f;
+
+	/**
+	* この間隔(フレーム)でシミュレーション状態を保存し、記録を途中から再開できるようにします
+	* Frames between two saved simulation states, recording can resume from the nearest one after a jump
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cache", meta = (ClampMin = "1"))
+	int32 KeyframeInterval = 30;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cache")
+	int32 NumBones = 0;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Cache")
+	int32 NumFrames = 0;
+
+	bool IsValidFor(int32 InNumBones) const
+	{
+		return NumFrames > 0 && NumBones == InNumBones && !bRecording;
+	}
+
+	bool IsRecording() const
+	{
+		return bRecording;
+	}
+
+	int32 GetFrameIndex(float Time) const
+	{
+		return FMath::Max(FMath::RoundToInt32(Time * FrameRate), 0);
+	}
+
+	/** Write the cached locations at Time into the bones (interpolated between frames, clamped to the last one) */
+	void SampleLocations(float Time, TArrayView<FKawaiiPhysicsModifyBone> Bones) const;
+
+	/** Start or continue a recording : frames already in the cache are kept until overwritten */
+	void BeginRecording(int32 InNumBones);
+
+	/**
+	* Record the bones at Frame, simulated with DeltaTime. Later frames are dropped since they no longer follow
+	* from this one. A keyframe is kept whenever a KeyframeInterval boundary is crossed
+	*/
+	void RecordFrame(int32 Frame, TConstArrayView<FKawaiiPhysicsModifyBone> Bones, float DeltaTime);
+
+	/**
+	* Restore the last keyframe at or before Frame into the bones, and drop the frames after it
+	* @return frame of the restored keyframe, INDEX_NONE if there is none
+	*/
+	int32 RestoreKeyframe(int32 Frame, TArrayView<FKawaiiPhysicsModifyBone> Bones, float& OutDeltaTime);
+
+	/**
+	* 記録を終了し、量子化して保存可能な状態にします
+	* Quantize the recording. Game thread only : marks the asset dirty
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics")
+	void FinishRecording();
+
+private:
+	FVector3f GetLocation(int32 Frame, int32 BoneIndex) const;
+
+	UPROPERTY()
+	TArray<FVector3f> BoundsMin;
+
+	UPROPERTY()
+	TArray<FVector3f> BoundsSize;
+
+	// NumFrames * NumBones * 3 : (Location - BoundsMin) / BoundsSize in [0, 65535]
+	UPROPERTY()
+	TArray<uint16> QuantizedLocations;
+
+	UPROPERTY()
+	TArray<FKawaiiPhysicsSimulationCacheKeyframe> Keyframes;
+
+	// Full precision frames while recording, NumFrames * NumBones
+	TArray<FVector3f> RecordingLocations;
+	bool bRecording = false;
+};
@@ -12,7 +12,7 @@ public class KawaiiPhysicsEd : ModuleRules
 		PrivateDependencyModuleNames.AddRange(new[]
 		{
 			"AnimGraph", "BlueprintGraph", "Persona", "UnrealEd", "AnimGraphRuntime", "Slate", "SlateCore",
-			"StructUtils"
+			"StructUtils", "AssetTools", "AssetRegistry"
 		});
 
 		BuildVersion Version;
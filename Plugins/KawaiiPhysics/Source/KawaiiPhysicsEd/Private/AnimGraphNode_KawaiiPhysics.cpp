@@ -3,6 +3,7 @@
 #include "DetailCategoryBuilder.h"
 #include "DetailLayoutBuilder.h"
 #include "DetailWidgetRow.h"
+#include "KawaiiPhysicsCustomExternalForce.h"
 #include "KawaiiPhysicsLimitsDataAsset.h"
 #include "Selection.h"
 #include "AssetRegistry/AssetRegistryModule.h"
@@ -86,6 +87,17 @@ void UAnimGraphNode_KawaiiPhysics::ValidateAnimNodePostCompile(FCompilerResultsL
 	{
 		MessageLog.Warning(TEXT("@@ RootBone is empty."), this);
 	}
+
+	for (const auto& CustomExternalForce : Node.CustomExternalForces)
+	{
+		if (CustomExternalForce && CustomExternalForce->ImplementsBlueprintApply())
+		{
+			MessageLog.Warning(*FString::Printf(
+				TEXT("@@ CustomExternalForce %s implements Apply in Blueprint. It runs per bone on the worker thread "
+					"and is not thread-safe. Compute parameters in PreApply or override ApplyBatch in C++ instead."),
+				*CustomExternalForce->GetClass()->GetName()), this);
+		}
+	}
 }
 
 void UAnimGraphNode_KawaiiPhysics::CopyNodeDataToPreviewNode(FAnimNode_Base* AnimNode)
@@ -119,6 +131,10 @@ void UAnimGraphNode_KawaiiPhysics::CopyNodeDataToPreviewNode(FAnimNode_Base* Ani
 	KawaiiPhysics->CapsuleLimits = Node.CapsuleLimits;
 	KawaiiPhysics->PlanarLimits = Node.PlanarLimits;
 	KawaiiPhysics->LimitsDataAsset = Node.LimitsDataAsset;
+	KawaiiPhysics->bShareLimitsDataAsset = Node.bShareLimitsDataAsset;
+	KawaiiPhysics->bUsePhysicsAssetAsLimits = Node.bUsePhysicsAssetAsLimits;
+	KawaiiPhysics->bEnableSelfCollision = Node.bEnableSelfCollision;
+	KawaiiPhysics->bUseSegmentCollision = Node.bUseSegmentCollision;
 
 	// ExternalForce
 	KawaiiPhysics->Gravity = Node.Gravity;
@@ -128,6 +144,8 @@ void UAnimGraphNode_KawaiiPhysics::CopyNodeDataToPreviewNode(FAnimNode_Base* Ani
 	// Wind
 	KawaiiPhysics->bEnableWind = Node.bEnableWind;
 	KawaiiPhysics->WindScale = Node.WindScale;
+	KawaiiPhysics->RandomSeed = Node.RandomSeed;
+	KawaiiPhysics->bDeriveRandomSeedFromOwner = Node.bDeriveRandomSeedFromOwner;
 
 	// BoneConstraint
 	KawaiiPhysics->BoneConstraintGlobalComplianceType = Node.BoneConstraintGlobalComplianceType;
@@ -137,6 +155,11 @@ void UAnimGraphNode_KawaiiPhysics::CopyNodeDataToPreviewNode(FAnimNode_Base* Ani
 	KawaiiPhysics->BoneConstraints = Node.BoneConstraints;
 	KawaiiPhysics->BoneConstraintsDataAsset = Node.BoneConstraintsDataAsset;
 
+	// SimulationCache (the time keeps running in the preview)
+	KawaiiPhysics->SimulationCacheMode = Node.SimulationCacheMode;
+	KawaiiPhysics->SimulationCache = Node.SimulationCache;
+	KawaiiPhysics->bAdvanceSimulationCacheTime = Node.bAdvanceSimulationCacheTime;
+
 	// Reset for sync without compile
 	KawaiiPhysics->ModifyBones.Empty();
 }
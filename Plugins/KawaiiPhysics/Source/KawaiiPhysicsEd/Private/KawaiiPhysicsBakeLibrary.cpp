@@ -0,0 +1,292 @@
+#include "KawaiiPhysicsBakeLibrary.h"
+
+#include "AnimNode_KawaiiPhysics.h"
+#include "AssetToolsModule.h"
+#include "Animation/AnimBlueprint.h"
+#include "Animation/AnimClassInterface.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimSequence.h"
+#include "Animation/AnimData/IAnimationDataController.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "Misc/PackageName.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(KawaiiPhysicsBakeLibrary)
+
+#define LOCTEXT_NAMESPACE "KawaiiPhysicsBake"
+
+DEFINE_LOG_CATEGORY_STATIC(LogKawaiiPhysicsBake, Log, All);
+
+namespace KawaiiPhysicsBake
+{
+	struct FBakedBoneTrack
+	{
+		FName BoneName;
+		int32 MeshBoneIndex = INDEX_NONE;
+		TArray<FVector3f> Positions;
+		TArray<FQuat4f> Rotations;
+		TArray<FVector3f> Scales;
+	};
+
+	// Non dummy bones simulated by the KawaiiPhysics nodes of the AnimInstance
+	void CollectSimulatedBones(UAnimInstance* AnimInstance, const FReferenceSkeleton& RefSkeleton,
+	                           TArray<FBakedBoneTrack>& OutTracks)
+	{
+		const IAnimClassInterface* AnimClass = IAnimClassInterface::GetFromClass(AnimInstance->GetClass());
+		if (!AnimClass)
+		{
+			return;
+		}
+
+		for (const FStructProperty* Property : AnimClass->GetAnimNodeProperties())
+		{
+			if (!Property->Struct->IsChildOf(FAnimNode_KawaiiPhysics::StaticStruct()))
+			{
+				continue;
+			}
+
+			const FAnimNode_KawaiiPhysics* Node = Property->ContainerPtrToValuePtr<FAnimNode_KawaiiPhysics>(
+				AnimInstance);
+			for (const FKawaiiPhysicsModifyBone& Bone : Node->ModifyBones)
+			{
+				const FName BoneName = Node->GetModifyBoneName(Bone.Index);
+				const int32 MeshBoneIndex = Bone.bDummy ? INDEX_NONE : RefSkeleton.FindBoneIndex(BoneName);
+				if (MeshBoneIndex != INDEX_NONE &&
+					!OutTracks.ContainsByPredicate([MeshBoneIndex](const FBakedBoneTrack& Track)
+					{
+						return Track.MeshBoneIndex == MeshBoneIndex;
+					}))
+				{
+					FBakedBoneTrack& Track = OutTracks.AddDefaulted_GetRef();
+					Track.BoneName = BoneName;
+					Track.MeshBoneIndex = MeshBoneIndex;
+				}
+			}
+		}
+	}
+
+	UAnimSequence* CreateBakedSequence(UAnimSequence* Source, const FKawaiiPhysicsBakeSettings& Settings)
+	{
+		const FString SourcePackagePath = FPackageName::GetLongPackagePath(Source->GetOutermost()->GetName());
+		const FString BasePackageName = (Settings.OutputPath.IsEmpty() ? SourcePackagePath : Settings.OutputPath) /
+			Source->GetName();
+
+		// Never overwrite a previous bake : it may be referenced
+		FString PackageName;
+		FString AssetName;
+		const FAssetToolsModule& AssetToolsModule = FModuleManager::LoadModuleChecked<FAssetToolsModule>(
+			TEXT("AssetTools"));
+		AssetToolsModule.Get().CreateUniqueAssetName(BasePackageName, Settings.Suffix, PackageName, AssetName);
+
+		UPackage* Package = CreatePackage(*PackageName);
+		UAnimSequence* Baked = DuplicateObject<UAnimSequence>(Source, Package, *AssetName);
+		Baked->SetFlags(RF_Public | RF_Standalone);
+		if (Settings.bAdditive)
+		{
+			// Base pose is the source itself : the additive holds only the simulation
+			Baked->AdditiveAnimType = AAT_LocalSpaceBase;
+			Baked->RefPoseType = ABPT_AnimScaled;
+			Baked->RefPoseSeq = Source;
+		}
+		return Baked;
+	}
+
+	void WriteTracks(UAnimSequence* Sequence, const TArray<FBakedBoneTrack>& Tracks)
+	{
+		IAnimationDataController& Controller = Sequence->GetController();
+		Controller.OpenBracket(LOCTEXT("BakeKawaiiPhysics", "Bake KawaiiPhysics"), false);
+		for (const FBakedBoneTrack& Track : Tracks)
+		{
+			if (!Sequence->GetDataModel()->IsValidBoneTrackName(Track.BoneName))
+			{
+#if	ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 2
+				Controller.AddBoneCurve(Track.BoneName, false);
+#else
+				Controller.AddBoneTrack(Track.BoneName, false);
+#endif
+			}
+			Controller.SetBoneTrackKeys(Track.BoneName, Track.Positions, Track.Rotations, Track.Scales, false);
+		}
+		Controller.CloseBracket(false);
+	}
+
+	UAnimSequence* BakeSequence(UWorld* World, UAnimSequence* Source, const FKawaiiPhysicsBakeSettings& Settings)
+	{
+		USkeletalMesh* Mesh = Settings.SkeletalMesh;
+		if (Source->GetSkeleton() != Mesh->GetSkeleton())
+		{
+			UE_LOG(LogKawaiiPhysicsBake, Warning, TEXT("%s : skeleton does not match %s, skipped"),
+			       *Source->GetPathName(), *Mesh->GetPathName());
+			return nullptr;
+		}
+
+		const int32 NumKeys = Source->GetNumberOfSampledKeys();
+		const float PlayLength = Source->GetPlayLength();
+		const float Interval = Source->GetSamplingFrameRate().AsInterval();
+		if (NumKeys < 2 || Interval <= 0.0f)
+		{
+			UE_LOG(LogKawaiiPhysicsBake, Warning, TEXT("%s has less than two keys, skipped"), *Source->GetPathName());
+			return nullptr;
+		}
+
+		// The source plays in place on the mesh, the AnimBlueprint runs on top of it as the post process
+		USkeletalMeshComponent* SkelComp = NewObject<USkeletalMeshComponent>(GetTransientPackage());
+		SkelComp->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+		SkelComp->bEnableUpdateRateOptimizations = false;
+#if	ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
+		SkelComp->SetSkeletalMeshAsset(Mesh);
+#else
+		SkelComp->SetSkeletalMesh(Mesh);
+#endif
+		SkelComp->SetOverridePostProcessAnimBP(Settings.AnimBlueprint->GeneratedClass);
+		SkelComp->RegisterComponentWithWorld(World);
+		SkelComp->PlayAnimation(Source, false);
+		// Time is driven by SetPosition : every tick advances the simulation by exactly one key
+		SkelComp->SetPlayRate(0.0f);
+
+		const auto TickAt = [SkelComp, Interval, PlayLength](int32 Key)
+		{
+			SkelComp->SetPosition(FMath::Min(Key * Interval, PlayLength), false);
+			SkelComp->TickAnimation(Interval, false);
+			SkelComp->RefreshBoneTransforms();
+		};
+
+		// First evaluation builds the ModifyBones
+		TickAt(0);
+
+		TArray<FBakedBoneTrack> Tracks;
+		if (UAnimInstance* PostProcessInstance = SkelComp->GetPostProcessInstance())
+		{
+			CollectSimulatedBones(PostProcessInstance, Mesh->GetRefSkeleton(), Tracks);
+		}
+		if (Tracks.IsEmpty())
+		{
+			UE_LOG(LogKawaiiPhysicsBake, Warning, TEXT("%s : no bone simulated by KawaiiPhysics in %s"),
+			       *Source->GetPathName(), *Settings.AnimBlueprint->GetPathName());
+			SkelComp->UnregisterComponent();
+			SkelComp->MarkAsGarbage();
+			return nullptr;
+		}
+
+		const bool bLoop = Source->bLoop;
+		if (bLoop)
+		{
+			// Play whole cycles until the chains are in the same state at each loop start
+			TArray<FVector> LoopStartLocations;
+			for (int32 Loop = 0; Loop < Settings.MaxWarmUpLoops; ++Loop)
+			{
+				for (int32 Key = 1; Key < NumKeys; ++Key)
+				{
+					TickAt(Key);
+				}
+
+				const TArray<FTransform>& ComponentSpaceTransforms = SkelComp->GetComponentSpaceTransforms();
+				bool bSteady = Loop > 0;
+				LoopStartLocations.SetNum(Tracks.Num());
+				for (int32 i = 0; i < Tracks.Num(); ++i)
+				{
+					const FVector Location = ComponentSpaceTransforms[Tracks[i].MeshBoneIndex].GetLocation();
+					if (Loop > 0 && FVector::Dist(Location, LoopStartLocations[i]) >= Settings.SteadyStateTolerance)
+					{
+						bSteady = false;
+					}
+					LoopStartLocations[i] = Location;
+				}
+				if (bSteady)
+				{
+					break;
+				}
+			}
+		}
+		else
+		{
+			// Let the chains settle on the first frame
+			for (float Time = 0.0f; Time < Settings.WarmUpTime; Time += Interval)
+			{
+				TickAt(0);
+			}
+		}
+
+		for (FBakedBoneTrack& Track : Tracks)
+		{
+			Track.Positions.SetNum(NumKeys);
+			Track.Rotations.SetNum(NumKeys);
+			Track.Scales.SetNum(NumKeys);
+		}
+
+		for (int32 Key = 0; Key < NumKeys; ++Key)
+		{
+			// Key 0 is the state reached by the warm-up
+			if (Key > 0)
+			{
+				TickAt(Key);
+			}
+
+			const TArray<FTransform>& BoneSpaceTransforms = SkelComp->GetBoneSpaceTransforms();
+			for (FBakedBoneTrack& Track : Tracks)
+			{
+				const int32 SourceKey = bLoop && Key == NumKeys - 1 ? 0 : Key;
+				const FTransform& Transform = BoneSpaceTransforms[Track.MeshBoneIndex];
+				if (SourceKey == Key)
+				{
+					Track.Positions[Key] = FVector3f(Transform.GetLocation());
+					Track.Rotations[Key] = FQuat4f(Transform.GetRotation());
+					Track.Scales[Key] = FVector3f(Transform.GetScale3D());
+				}
+				else
+				{
+					// Looping : the last key is the first one so that the baked loop is seamless
+					Track.Positions[Key] = Track.Positions[SourceKey];
+					Track.Rotations[Key] = Track.Rotations[SourceKey];
+					Track.Scales[Key] = Track.Scales[SourceKey];
+				}
+			}
+		}
+
+		SkelComp->UnregisterComponent();
+		SkelComp->MarkAsGarbage();
+
+		UAnimSequence* Baked = CreateBakedSequence(Source, Settings);
+		WriteTracks(Baked, Tracks);
+
+		FAssetRegistryModule::AssetCreated(Baked);
+		Baked->MarkPackageDirty();
+
+		UE_LOG(LogKawaiiPhysicsBake, Display, TEXT("Baked %d bones of %s into %s"), Tracks.Num(),
+		       *Source->GetPathName(), *Baked->GetPathName());
+		return Baked;
+	}
+}
+
+TArray<UAnimSequence*> UKawaiiPhysicsBakeLibrary::BakeKawaiiPhysics(const FKawaiiPhysicsBakeSettings& Settings)
+{
+	TArray<UAnimSequence*> BakedSequences;
+	if (!Settings.SkeletalMesh || !Settings.AnimBlueprint || !Settings.AnimBlueprint->GeneratedClass)
+	{
+		UE_LOG(LogKawaiiPhysicsBake, Error, TEXT("BakeKawaiiPhysics needs a SkeletalMesh and a compiled AnimBlueprint"));
+		return BakedSequences;
+	}
+
+	// Components need a world to initialize their AnimInstance, but nothing is rendered
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("KawaiiPhysicsBake"));
+
+	for (UAnimSequence* Source : Settings.SourceAnimations)
+	{
+		if (Source)
+		{
+			if (UAnimSequence* Baked = KawaiiPhysicsBake::BakeSequence(World, Source, Settings))
+			{
+				BakedSequences.Add(Baked);
+			}
+		}
+	}
+
+	World->DestroyWorld(false);
+
+	return BakedSequences;
+}
+
+#undef LOCTEXT_NAMESPACE
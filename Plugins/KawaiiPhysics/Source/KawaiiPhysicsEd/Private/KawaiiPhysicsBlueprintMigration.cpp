@@ -0,0 +1,368 @@
+#include "KawaiiPhysicsBlueprintMigration.h"
+
+#include "AnimNode_KawaiiPhysics.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "EdGraphSchema_K2.h"
+#include "Editor.h"
+#include "Engine/Blueprint.h"
+#include "HAL/IConsoleManager.h"
+#include "K2Node_BreakStruct.h"
+#include "K2Node_CallFunction.h"
+#include "K2Node_EditablePinBase.h"
+#include "K2Node_SetFieldsInStruct.h"
+#include "KawaiiPhysics.h"
+#include "KawaiiPhysicsLibrary.h"
+#include "Kismet/KismetMathLibrary.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/KismetEditorUtilities.h"
+#include "Misc/CoreDelegates.h"
+
+namespace KawaiiPhysicsBlueprintMigration
+{
+	namespace
+	{
+		FDelegateHandle PostEngineInitHandle;
+		FDelegateHandle BlueprintPreCompileHandle;
+
+		// Pin names of K2Node_SetFieldsInStruct
+		const FName StructRefPinName(TEXT("StructRef"));
+		const FName StructOutPinName(TEXT("StructOut"));
+
+		UK2Node_CallFunction* SpawnCallFunction(UEdGraph& Graph, const UEdGraphNode& Anchor, const UClass* Class,
+		                                        FName FunctionName, int32 OffsetY)
+		{
+			FGraphNodeCreator<UK2Node_CallFunction> NodeCreator(Graph);
+			UK2Node_CallFunction* CallFunction = NodeCreator.CreateNode();
+			CallFunction->SetFromFunction(Class->FindFunctionByName(FunctionName));
+			CallFunction->NodePosX = Anchor.NodePosX;
+			CallFunction->NodePosY = Anchor.NodePosY + OffsetY;
+			NodeCreator.Finalize();
+			return CallFunction;
+		}
+
+		// The custom external force functions (PreApply, Apply) receive the node as a parameter
+		UEdGraphPin* FindNodeParameterPin(const UEdGraph& Graph)
+		{
+			TArray<UK2Node_EditablePinBase*> EntryNodes;
+			Graph.GetNodesOfClass(EntryNodes);
+			for (UK2Node_EditablePinBase* EntryNode : EntryNodes)
+			{
+				for (UEdGraphPin* Pin : EntryNode->Pins)
+				{
+					if (Pin->Direction == EGPD_Output &&
+						Pin->PinType.PinSubCategoryObject == FAnimNode_KawaiiPhysics::StaticStruct())
+					{
+						return Pin;
+					}
+				}
+			}
+			return nullptr;
+		}
+
+		// Library functions reading the node state (GetModifyBonePoseTransform etc.) also take the node
+		bool ConnectNodePin(UK2Node_CallFunction* CallFunction, const UBlueprint* Blueprint)
+		{
+			UEdGraphPin* NodePin = CallFunction->FindPin(TEXT("Node"), EGPD_Input);
+			if (!NodePin || NodePin->LinkedTo.Num() > 0)
+			{
+				return false;
+			}
+
+			UEdGraphPin* NodeParameterPin = FindNodeParameterPin(*CallFunction->GetGraph());
+			if (!NodeParameterPin || !GetDefault<UEdGraphSchema_K2>()->TryCreateConnection(NodeParameterPin, NodePin))
+			{
+				UE_LOG(LogKawaiiPhysics, Warning, TEXT("%s : Node of %s could not be connected, please fix it by hand"),
+				       *Blueprint->GetPathName(),
+				       *CallFunction->GetNodeTitle(ENodeTitleType::ListView).ToString());
+				return false;
+			}
+			return true;
+		}
+
+		// Links that do not fit the new pin (e.g. PoseRotation was a quaternion) are dropped and reported
+		void MoveLinks(UEdGraphPin* From, UEdGraphPin* To, const UBlueprint* Blueprint)
+		{
+			const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+			const TArray<UEdGraphPin*> LinkedPins = From->LinkedTo;
+			From->BreakAllPinLinks();
+			for (UEdGraphPin* LinkedPin : LinkedPins)
+			{
+				if (!To || !Schema->TryCreateConnection(To, LinkedPin))
+				{
+					UE_LOG(LogKawaiiPhysics, Warning,
+					       TEXT("%s : %s of %s could not be reconnected, please fix it by hand"),
+					       *Blueprint->GetPathName(), *From->PinName.ToString(),
+					       *From->GetOwningNode()->GetNodeTitle(ENodeTitleType::ListView).ToString());
+				}
+			}
+		}
+
+		int32 MigrateBreakStruct(UBlueprint* Blueprint, UK2Node_BreakStruct* BreakNode)
+		{
+			const UEdGraphPin* StructPin = BreakNode->FindPin(BreakNode->StructType->GetFName(), EGPD_Input);
+			if (!StructPin || StructPin->LinkedTo.Num() == 0)
+			{
+				return 0;
+			}
+			UEdGraphPin* SourcePin = StructPin->LinkedTo[0];
+
+			const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+			UEdGraph& Graph = *BreakNode->GetGraph();
+			UK2Node_CallFunction* BreakPoseTransform = nullptr;
+			int32 NumMigrated = 0;
+
+			// The pins of the removed members are kept as orphaned pins while they are linked
+			for (UEdGraphPin* Pin : TArray<UEdGraphPin*>(BreakNode->Pins))
+			{
+				if (Pin->Direction != EGPD_Output || Pin->LinkedTo.Num() == 0)
+				{
+					continue;
+				}
+
+				UEdGraphPin* NewPin = nullptr;
+				if (Pin->PinName == GET_MEMBER_NAME_CHECKED(FKawaiiPhysicsModifyBone, Location) ||
+					Pin->PinName == GET_MEMBER_NAME_CHECKED(FKawaiiPhysicsModifyBone, PrevLocation))
+				{
+					const bool bLocation = Pin->PinName == GET_MEMBER_NAME_CHECKED(FKawaiiPhysicsModifyBone, Location);
+					UK2Node_CallFunction* GetLocation = SpawnCallFunction(
+						Graph, *BreakNode, UKawaiiPhysicsLibrary::StaticClass(),
+						bLocation
+							? GET_FUNCTION_NAME_CHECKED(UKawaiiPhysicsLibrary, GetModifyBoneLocation)
+							: GET_FUNCTION_NAME_CHECKED(UKawaiiPhysicsLibrary, GetModifyBonePrevLocation),
+						(NumMigrated + 1) * 100);
+					Schema->TryCreateConnection(SourcePin, GetLocation->FindPinChecked(TEXT("ModifyBone")));
+					NewPin = GetLocation->GetReturnValuePin();
+				}
+				else if (Pin->PinName == TEXT("PoseLocation") || Pin->PinName == TEXT("PoseRotation") ||
+					Pin->PinName == TEXT("PoseScale"))
+				{
+					if (!BreakPoseTransform)
+					{
+						UK2Node_CallFunction* GetPoseTransform = SpawnCallFunction(
+							Graph, *BreakNode, UKawaiiPhysicsLibrary::StaticClass(),
+							GET_FUNCTION_NAME_CHECKED(UKawaiiPhysicsLibrary, GetModifyBonePoseTransform),
+							(NumMigrated + 1) * 100);
+						Schema->TryCreateConnection(SourcePin, GetPoseTransform->FindPinChecked(TEXT("ModifyBone")));
+						ConnectNodePin(GetPoseTransform, Blueprint);
+						BreakPoseTransform = SpawnCallFunction(
+							Graph, *GetPoseTransform, UKismetMathLibrary::StaticClass(),
+							GET_FUNCTION_NAME_CHECKED(UKismetMathLibrary, BreakTransform), 100);
+						Schema->TryCreateConnection(GetPoseTransform->GetReturnValuePin(),
+						                            BreakPoseTransform->FindPinChecked(TEXT("InTransform")));
+					}
+					NewPin = BreakPoseTransform->FindPin(Pin->PinName == TEXT("PoseLocation")
+						                                     ? TEXT("Location")
+						                                     : Pin->PinName == TEXT("PoseRotation")
+						                                     ? TEXT("Rotation")
+						                                     : TEXT("Scale"));
+				}
+				else if (Pin->PinName == TEXT("ChildIndexs"))
+				{
+					UK2Node_CallFunction* GetChildIndices = SpawnCallFunction(
+						Graph, *BreakNode, UKawaiiPhysicsLibrary::StaticClass(),
+						GET_FUNCTION_NAME_CHECKED(UKawaiiPhysicsLibrary, GetModifyBoneChildIndices),
+						(NumMigrated + 1) * 100);
+					Schema->TryCreateConnection(SourcePin, GetChildIndices->FindPinChecked(TEXT("ModifyBone")));
+					ConnectNodePin(GetChildIndices, Blueprint);
+					NewPin = GetChildIndices->GetReturnValuePin();
+				}
+				else
+				{
+					continue;
+				}
+
+				MoveLinks(Pin, NewPin, Blueprint);
+				++NumMigrated;
+			}
+
+			const bool bStillUsed = BreakNode->Pins.ContainsByPredicate([](const UEdGraphPin* Pin)
+			{
+				return Pin->Direction == EGPD_Output && Pin->LinkedTo.Num() > 0;
+			});
+			if (NumMigrated > 0 && !bStillUsed)
+			{
+				FBlueprintEditorUtils::RemoveNode(Blueprint, BreakNode, true);
+			}
+			return NumMigrated;
+		}
+
+		int32 MigrateSetFieldsInStruct(UBlueprint* Blueprint, UK2Node_SetFieldsInStruct* SetNode)
+		{
+			UEdGraphPin* LocationPin = SetNode->FindPin(GET_MEMBER_NAME_CHECKED(FKawaiiPhysicsModifyBone, Location),
+			                                            EGPD_Input);
+			const UEdGraphPin* StructRefPin = SetNode->FindPin(StructRefPinName, EGPD_Input);
+			if (!LocationPin || !StructRefPin || StructRefPin->LinkedTo.Num() == 0)
+			{
+				return 0;
+			}
+			UEdGraphPin* SourcePin = StructRefPin->LinkedTo[0];
+
+			const UEdGraphSchema_K2* Schema = GetDefault<UEdGraphSchema_K2>();
+			UK2Node_CallFunction* SetLocation = SpawnCallFunction(
+				*SetNode->GetGraph(), *SetNode, UKawaiiPhysicsLibrary::StaticClass(),
+				GET_FUNCTION_NAME_CHECKED(UKawaiiPhysicsLibrary, SetModifyBoneLocation), 150);
+			Schema->TryCreateConnection(SourcePin, SetLocation->FindPinChecked(TEXT("ModifyBone")));
+			UEdGraphPin* NewLocationPin = SetLocation->FindPinChecked(TEXT("Location"));
+			if (LocationPin->LinkedTo.Num() > 0)
+			{
+				MoveLinks(LocationPin, NewLocationPin, Blueprint);
+			}
+			else
+			{
+				Schema->TrySetDefaultValue(*NewLocationPin, LocationPin->DefaultValue);
+			}
+
+			// Location was the only writable member : the node is kept only if it still sets something else
+			const bool bSetsOtherMembers = SetNode->ShowPinForProperties.ContainsByPredicate(
+				[](const FOptionalPinFromProperty& OptionalPin)
+				{
+					return OptionalPin.bShowPin &&
+						OptionalPin.PropertyName != GET_MEMBER_NAME_CHECKED(FKawaiiPhysicsModifyBone, Location);
+				});
+			const UEdGraphPin* StructOutPin = SetNode->FindPin(StructOutPinName, EGPD_Output);
+			UEdGraphPin* ThenPin = SetNode->FindPinChecked(UEdGraphSchema_K2::PN_Then);
+			if (bSetsOtherMembers || (StructOutPin && StructOutPin->LinkedTo.Num() > 0))
+			{
+				MoveLinks(ThenPin, SetLocation->GetThenPin(), Blueprint);
+				Schema->TryCreateConnection(ThenPin, SetLocation->GetExecPin());
+				for (FOptionalPinFromProperty& OptionalPin : SetNode->ShowPinForProperties)
+				{
+					if (OptionalPin.PropertyName == GET_MEMBER_NAME_CHECKED(FKawaiiPhysicsModifyBone, Location))
+					{
+						OptionalPin.bShowPin = false;
+					}
+				}
+				SetNode->ReconstructNode();
+			}
+			else
+			{
+				MoveLinks(SetNode->FindPinChecked(UEdGraphSchema_K2::PN_Execute), SetLocation->GetExecPin(),
+				          Blueprint);
+				MoveLinks(ThenPin, SetLocation->GetThenPin(), Blueprint);
+				FBlueprintEditorUtils::RemoveNode(Blueprint, SetNode, true);
+			}
+			return 1;
+		}
+
+		void MigrateAllBlueprints()
+		{
+			// Only the packages importing the KawaiiPhysics module can use FKawaiiPhysicsModifyBone
+			IAssetRegistry& AssetRegistry =
+				FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+			TArray<FName> Referencers;
+			AssetRegistry.GetReferencers(FName(TEXT("/Script/KawaiiPhysics")), Referencers);
+
+			int32 NumBlueprints = 0;
+			for (const FName& PackageName : Referencers)
+			{
+				TArray<FAssetData> Assets;
+				AssetRegistry.GetAssetsByPackageName(PackageName, Assets);
+				for (const FAssetData& Asset : Assets)
+				{
+					const UClass* AssetClass = Asset.GetClass();
+					if (!AssetClass || !AssetClass->IsChildOf(UBlueprint::StaticClass()))
+					{
+						continue;
+					}
+
+					UBlueprint* Blueprint = Cast<UBlueprint>(Asset.GetAsset());
+					if (MigrateModifyBonePins(Blueprint) > 0)
+					{
+						FKismetEditorUtilities::CompileBlueprint(Blueprint);
+						Blueprint->MarkPackageDirty();
+						++NumBlueprints;
+					}
+				}
+			}
+
+			UE_LOG(LogKawaiiPhysics, Log, TEXT("%d Blueprint(s) migrated. Save them to keep the changes"),
+			       NumBlueprints);
+		}
+
+		FAutoConsoleCommand MigrateModifyBoneBlueprintsCommand(
+			TEXT("KawaiiPhysics.MigrateModifyBoneBlueprints"),
+			TEXT("Replace the FKawaiiPhysicsModifyBone members that are no longer Blueprint visible by ")
+			TEXT("UKawaiiPhysicsLibrary calls in every Blueprint using KawaiiPhysics"),
+			FConsoleCommandDelegate::CreateStatic(&MigrateAllBlueprints));
+	}
+
+	int32 MigrateModifyBonePins(UBlueprint* Blueprint)
+	{
+		if (!Blueprint)
+		{
+			return 0;
+		}
+
+		int32 NumMigrated = 0;
+
+		TArray<UK2Node_BreakStruct*> BreakNodes;
+		FBlueprintEditorUtils::GetAllNodesOfClass(Blueprint, BreakNodes);
+		for (UK2Node_BreakStruct* BreakNode : BreakNodes)
+		{
+			if (BreakNode->StructType == FKawaiiPhysicsModifyBone::StaticStruct())
+			{
+				NumMigrated += MigrateBreakStruct(Blueprint, BreakNode);
+			}
+		}
+
+		// Calls placed before the functions took the node
+		TArray<UK2Node_CallFunction*> CallFunctions;
+		FBlueprintEditorUtils::GetAllNodesOfClass(Blueprint, CallFunctions);
+		for (UK2Node_CallFunction* CallFunction : CallFunctions)
+		{
+			const FName FunctionName = CallFunction->FunctionReference.GetMemberName();
+			if (CallFunction->FunctionReference.GetMemberParentClass() == UKawaiiPhysicsLibrary::StaticClass() &&
+				(FunctionName == GET_FUNCTION_NAME_CHECKED(UKawaiiPhysicsLibrary, GetModifyBonePoseTransform) ||
+					FunctionName == GET_FUNCTION_NAME_CHECKED(UKawaiiPhysicsLibrary, GetModifyBoneChildIndices)) &&
+				ConnectNodePin(CallFunction, Blueprint))
+			{
+				++NumMigrated;
+			}
+		}
+
+		TArray<UK2Node_SetFieldsInStruct*> SetNodes;
+		FBlueprintEditorUtils::GetAllNodesOfClass(Blueprint, SetNodes);
+		for (UK2Node_SetFieldsInStruct* SetNode : SetNodes)
+		{
+			if (SetNode->StructType == FKawaiiPhysicsModifyBone::StaticStruct())
+			{
+				NumMigrated += MigrateSetFieldsInStruct(Blueprint, SetNode);
+			}
+		}
+
+		if (NumMigrated > 0)
+		{
+			UE_LOG(LogKawaiiPhysics, Log,
+			       TEXT("%s : %d FKawaiiPhysicsModifyBone pin(s) replaced by UKawaiiPhysicsLibrary calls"),
+			       *Blueprint->GetPathName(), NumMigrated);
+		}
+		return NumMigrated;
+	}
+
+	void Register()
+	{
+		// The editor module is loaded before GEditor exists
+		PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddLambda([]()
+		{
+			if (GEditor)
+			{
+				BlueprintPreCompileHandle = GEditor->OnBlueprintPreCompile().AddLambda([](UBlueprint* Blueprint)
+				{
+					if (MigrateModifyBonePins(Blueprint) > 0)
+					{
+						Blueprint->MarkPackageDirty();
+					}
+				});
+			}
+		});
+	}
+
+	void Unregister()
+	{
+		FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+		if (GEditor)
+		{
+			GEditor->OnBlueprintPreCompile().Remove(BlueprintPreCompileHandle);
+		}
+	}
+}
@@ -4,6 +4,7 @@
 #include "Modules/ModuleManager.h"
 #include "Textures/SlateIcon.h"
 #include "KawaiiPhysicsEditMode.h"
+#include "KawaiiPhysicsBlueprintMigration.h"
 
 #define LOCTEXT_NAMESPACE "FKawaiiPhysicsModuleEd"
 
@@ -13,12 +14,14 @@ void FKawaiiPhysicsEdModule::StartupModule()
 	FEditorModeRegistry::Get().RegisterMode<FKawaiiPhysicsEditMode>("AnimGraph.SkeletalControl.KawaiiPhysics",
 	                                                                LOCTEXT("FKawaiiPhysicsEditMode", "Kawaii Physics"),
 	                                                                FSlateIcon(), false);
+	KawaiiPhysicsBlueprintMigration::Register();
 }
 
 
 void FKawaiiPhysicsEdModule::ShutdownModule()
 {
 	FEditorModeRegistry::Get().UnregisterMode("AnimGraph.SkeletalControl.KawaiiPhysics");
+	KawaiiPhysicsBlueprintMigration::Unregister();
 }
 
 #undef LOCTEXT_NAMESPACE
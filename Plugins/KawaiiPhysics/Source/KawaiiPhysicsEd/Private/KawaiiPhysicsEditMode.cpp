@@ -54,9 +54,6 @@ void FKawaiiPhysicsEditMode::EnterMode(UAnimGraphNode_Base* InEditorNode, FAnimN
 
 
 	// for Sync DetailPanel
-	GraphNode->Node.SphericalLimitsData = RuntimeNode->SphericalLimitsData;
-	GraphNode->Node.CapsuleLimitsData = RuntimeNode->CapsuleLimitsData;
-	GraphNode->Node.PlanarLimitsData = RuntimeNode->PlanarLimitsData;
 	GraphNode->Node.BoneConstraintsData = RuntimeNode->BoneConstraintsData;
 	GraphNode->Node.MergedBoneConstraints = RuntimeNode->MergedBoneConstraints;
 
@@ -107,19 +104,27 @@ void FKawaiiPhysicsEditMode::Render(const FSceneView* View, FViewport* Viewport,
 
 		if (IsValidSelectCollision())
 		{
-			if (const FCollisionLimitBase* Collision = GetSelectCollisionLimitRuntime())
+			const FCollisionLimitBase* Collision = GetSelectCollisionLimitRuntime();
+			FVector CollisionLocation;
+			FQuat CollisionRotation;
+			if (Collision && GetSelectCollisionTransform(CollisionLocation, CollisionRotation))
 			{
+				// The limits of a LimitsDataAsset are not initialized on a BoneContainer
 				FTransform BoneTransform = FTransform::Identity;
-				if (Collision->DrivingBone.BoneIndex >= 0 && RuntimeNode->ForwardedPose.GetPose().GetNumBones() > 0)
+				FBoneReference DrivingBone = Collision->DrivingBone;
+				if (RuntimeNode->ForwardedPose.GetPose().GetNumBones() > 0)
 				{
-					BoneTransform = RuntimeNode->ForwardedPose.GetComponentSpaceTransform(
-						Collision->DrivingBone.GetCompactPoseIndex(
-							RuntimeNode->ForwardedPose.GetPose().GetBoneContainer()));
+					const FBoneContainer& BoneContainer = RuntimeNode->ForwardedPose.GetPose().GetBoneContainer();
+					if (DrivingBone.Initialize(BoneContainer) && DrivingBone.IsValidToEvaluate(BoneContainer))
+					{
+						BoneTransform = RuntimeNode->ForwardedPose.GetComponentSpaceTransform(
+							DrivingBone.GetCompactPoseIndex(BoneContainer));
+					}
 				}
 				PDI->DrawPoint(BoneTransform.GetLocation(), FLinearColor::White, 10.0f, SDPG_Foreground);
-				DrawDashedLine(PDI, Collision->Location, BoneTransform.GetLocation(),
+				DrawDashedLine(PDI, CollisionLocation, BoneTransform.GetLocation(),
 				               FLinearColor::White, 1, SDPG_Foreground);
-				DrawCoordinateSystem(PDI, BoneTransform.GetLocation(), Collision->Rotation.Rotator(), 20,
+				DrawCoordinateSystem(PDI, BoneTransform.GetLocation(), CollisionRotation.Rotator(), 20,
 				                     SDPG_World + 1);
 			}
 		}
@@ -134,17 +139,18 @@ void FKawaiiPhysicsEditMode::RenderModifyBones(FPrimitiveDrawInterface* PDI) con
 	{
 		for (auto& Bone : RuntimeNode->ModifyBones)
 		{
-			PDI->DrawPoint(Bone.Location, FLinearColor::White, 5.0f, SDPG_Foreground);
+			const FVector Location(Bone.Location);
+			PDI->DrawPoint(Location, FLinearColor::White, 5.0f, SDPG_Foreground);
 
 			if (Bone.PhysicsSettings.Radius > 0)
 			{
 				auto Color = Bone.bDummy ? FColor::Red : FColor::Yellow;
-				DrawWireSphere(PDI, Bone.Location, Color, Bone.PhysicsSettings.Radius, 16, SDPG_Foreground);
+				DrawWireSphere(PDI, Location, Color, Bone.PhysicsSettings.Radius, 16, SDPG_Foreground);
 			}
 
-			for (const int32 ChildIndex : Bone.ChildIndexs)
+			for (const int32 ChildIndex : RuntimeNode->GetChildIndices(Bone))
 			{
-				DrawDashedLine(PDI, Bone.Location, RuntimeNode->ModifyBones[ChildIndex].Location,
+				DrawDashedLine(PDI, Location, FVector(RuntimeNode->ModifyBones[ChildIndex].Location),
 				               FLinearColor::White, 1, SDPG_Foreground);
 			}
 		}
@@ -161,23 +167,27 @@ void FKawaiiPhysicsEditMode::RenderSphericalLimits(FPrimitiveDrawInterface* PDI)
 			if (Sphere.bEnable && Sphere.Radius > 0)
 			{
 				PDI->SetHitProxy(new HKawaiiPhysicsHitProxy(ECollisionLimitType::Spherical, i));
-				DrawSphere(PDI, Sphere.Location, FRotator::ZeroRotator, FVector(Sphere.Radius), 24, 6,
+				const FVector Location(Sphere.Location);
+				DrawSphere(PDI, Location, FRotator::ZeroRotator, FVector(Sphere.Radius), 24, 6,
 				           GEngine->ConstraintLimitMaterialPrismatic->GetRenderProxy(), SDPG_World);
-				DrawWireSphere(PDI, Sphere.Location, FLinearColor::Black, Sphere.Radius, 24, SDPG_World);
-				DrawCoordinateSystem(PDI, Sphere.Location, Sphere.Rotation.Rotator(), Sphere.Radius, SDPG_World + 1);
+				DrawWireSphere(PDI, Location, FLinearColor::Black, Sphere.Radius, 24, SDPG_World);
+				DrawCoordinateSystem(PDI, Location, FQuat(Sphere.Rotation).Rotator(), Sphere.Radius, SDPG_World + 1);
 			}
 		}
 
-		for (int32 i = 0; i < RuntimeNode->SphericalLimitsData.Num(); i++)
+		const TConstArrayView<FSphericalLimit> Definitions = RuntimeNode->GetSphericalLimitsDataDefinitions();
+		const TConstArrayView<FKawaiiPhysicsLimitInstance> Instances = RuntimeNode->GetSphericalLimitsDataInstances();
+		for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); i++)
 		{
-			auto& Sphere = RuntimeNode->SphericalLimitsData[i];
-			if (Sphere.bEnable && Sphere.Radius > 0)
+			const float Radius = Definitions[i].Radius;
+			if (Instances[i].bEnable && Radius > 0)
 			{
 				PDI->SetHitProxy(new HKawaiiPhysicsHitProxy(ECollisionLimitType::Spherical, i, true));
-				DrawSphere(PDI, Sphere.Location, FRotator::ZeroRotator, FVector(Sphere.Radius), 24, 6,
+				const FVector Location(Instances[i].Location);
+				DrawSphere(PDI, Location, FRotator::ZeroRotator, FVector(Radius), 24, 6,
 				           GEngine->ConstraintLimitMaterialZ->GetRenderProxy(), SDPG_World);
-				DrawWireSphere(PDI, Sphere.Location, FLinearColor::Black, Sphere.Radius, 24, SDPG_World);
-				DrawCoordinateSystem(PDI, Sphere.Location, Sphere.Rotation.Rotator(), Sphere.Radius, SDPG_World + 1);
+				DrawWireSphere(PDI, Location, FLinearColor::Black, Radius, 24, SDPG_World);
+				DrawCoordinateSystem(PDI, Location, FQuat(Instances[i].Rotation).Rotator(), Radius, SDPG_World + 1);
 			}
 		}
 	}
@@ -192,52 +202,58 @@ void FKawaiiPhysicsEditMode::RenderCapsuleLimit(FPrimitiveDrawInterface* PDI) co
 			auto& Capsule = RuntimeNode->CapsuleLimits[i];
 			if (Capsule.bEnable && Capsule.Radius > 0 && Capsule.Length > 0)
 			{
-				FVector XAxis = Capsule.Rotation.GetAxisX();
-				FVector YAxis = Capsule.Rotation.GetAxisY();
-				FVector ZAxis = Capsule.Rotation.GetAxisZ();
+				const FVector Location(Capsule.Location);
+				const FQuat Rotation(Capsule.Rotation);
+				FVector XAxis = Rotation.GetAxisX();
+				FVector YAxis = Rotation.GetAxisY();
+				FVector ZAxis = Rotation.GetAxisZ();
 
 				PDI->SetHitProxy(new HKawaiiPhysicsHitProxy(ECollisionLimitType::Capsule, i));
-				DrawCylinder(PDI, Capsule.Location, XAxis, YAxis, ZAxis, Capsule.Radius, 0.5f * Capsule.Length, 25,
+				DrawCylinder(PDI, Location, XAxis, YAxis, ZAxis, Capsule.Radius, 0.5f * Capsule.Length, 25,
 				             GEngine->ConstraintLimitMaterialPrismatic->GetRenderProxy(), SDPG_World);
-				DrawSphere(PDI, Capsule.Location + ZAxis * Capsule.Length * 0.5f, Capsule.Rotation.Rotator(),
+				DrawSphere(PDI, Location + ZAxis * Capsule.Length * 0.5f, Rotation.Rotator(),
 				           FVector(Capsule.Radius),
 				           24, 6, GEngine->ConstraintLimitMaterialPrismatic->GetRenderProxy(), SDPG_World);
-				DrawSphere(PDI, Capsule.Location - ZAxis * Capsule.Length * 0.5f, Capsule.Rotation.Rotator(),
+				DrawSphere(PDI, Location - ZAxis * Capsule.Length * 0.5f, Rotation.Rotator(),
 				           FVector(Capsule.Radius),
 				           24, 6, GEngine->ConstraintLimitMaterialPrismatic->GetRenderProxy(), SDPG_World);
 
-				DrawWireCapsule(PDI, Capsule.Location, XAxis, YAxis, ZAxis,
+				DrawWireCapsule(PDI, Location, XAxis, YAxis, ZAxis,
 				                FLinearColor::Black, Capsule.Radius, 0.5f * Capsule.Length + Capsule.Radius, 25,
 				                SDPG_World);
 
-				DrawCoordinateSystem(PDI, Capsule.Location, Capsule.Rotation.Rotator(), Capsule.Radius, SDPG_World + 1);
+				DrawCoordinateSystem(PDI, Location, Rotation.Rotator(), Capsule.Radius, SDPG_World + 1);
 			}
 		}
 
-		for (int32 i = 0; i < RuntimeNode->CapsuleLimitsData.Num(); i++)
+		const TConstArrayView<FCapsuleLimit> Definitions = RuntimeNode->GetCapsuleLimitsDataDefinitions();
+		const TConstArrayView<FKawaiiPhysicsLimitInstance> Instances = RuntimeNode->GetCapsuleLimitsDataInstances();
+		for (int32 i = 0; i < FMath::Min(Definitions.Num(), Instances.Num()); i++)
 		{
-			auto& Capsule = RuntimeNode->CapsuleLimitsData[i];
-			if (Capsule.bEnable && Capsule.Radius > 0 && Capsule.Length > 0)
+			const FCapsuleLimit& Capsule = Definitions[i];
+			if (Instances[i].bEnable && Capsule.Radius > 0 && Capsule.Length > 0)
 			{
-				FVector XAxis = Capsule.Rotation.GetAxisX();
-				FVector YAxis = Capsule.Rotation.GetAxisY();
-				FVector ZAxis = Capsule.Rotation.GetAxisZ();
+				const FVector Location(Instances[i].Location);
+				const FQuat Rotation(Instances[i].Rotation);
+				FVector XAxis = Rotation.GetAxisX();
+				FVector YAxis = Rotation.GetAxisY();
+				FVector ZAxis = Rotation.GetAxisZ();
 
 				PDI->SetHitProxy(new HKawaiiPhysicsHitProxy(ECollisionLimitType::Capsule, i, true));
-				DrawCylinder(PDI, Capsule.Location, XAxis, YAxis, ZAxis, Capsule.Radius, 0.5f * Capsule.Length, 25,
+				DrawCylinder(PDI, Location, XAxis, YAxis, ZAxis, Capsule.Radius, 0.5f * Capsule.Length, 25,
 				             GEngine->ConstraintLimitMaterialZ->GetRenderProxy(), SDPG_World);
-				DrawSphere(PDI, Capsule.Location + ZAxis * Capsule.Length * 0.5f, Capsule.Rotation.Rotator(),
+				DrawSphere(PDI, Location + ZAxis * Capsule.Length * 0.5f, Rotation.Rotator(),
 				           FVector(Capsule.Radius),
 				           24, 6, GEngine->ConstraintLimitMaterialZ->GetRenderProxy(), SDPG_World);
-				DrawSphere(PDI, Capsule.Location - ZAxis * Capsule.Length * 0.5f, Capsule.Rotation.Rotator(),
+				DrawSphere(PDI, Location - ZAxis * Capsule.Length * 0.5f, Rotation.Rotator(),
 				           FVector(Capsule.Radius),
 				           24, 6, GEngine->ConstraintLimitMaterialZ->GetRenderProxy(), SDPG_World);
 
-				DrawWireCapsule(PDI, Capsule.Location, XAxis, YAxis, ZAxis,
+				DrawWireCapsule(PDI, Location, XAxis, YAxis, ZAxis,
 				                FLinearColor::Black, Capsule.Radius, 0.5f * Capsule.Length + Capsule.Radius, 25,
 				                SDPG_World);
 
-				DrawCoordinateSystem(PDI, Capsule.Location, Capsule.Rotation.Rotator(), Capsule.Radius, SDPG_World + 1);
+				DrawCoordinateSystem(PDI, Location, Rotation.Rotator(), Capsule.Radius, SDPG_World + 1);
 			}
 		}
 	}
@@ -250,7 +266,7 @@ void FKawaiiPhysicsEditMode::RenderPlanerLimit(FPrimitiveDrawInterface* PDI)
 		for (int32 i = 0; i < RuntimeNode->PlanarLimits.Num(); i++)
 		{
 			auto& Plane = RuntimeNode->PlanarLimits[i];
-			FTransform PlaneTransform = FTransform(Plane.Rotation, Plane.Location);
+			FTransform PlaneTransform = FTransform(FQuat(Plane.Rotation), FVector(Plane.Location));
 			PlaneTransform.NormalizeRotation();
 
 			PDI->SetHitProxy(new HKawaiiPhysicsHitProxy(ECollisionLimitType::Planar, i));
@@ -261,10 +277,11 @@ void FKawaiiPhysicsEditMode::RenderPlanerLimit(FPrimitiveDrawInterface* PDI)
 			                     FLinearColor::Blue, 50.0f, 20.0f, SDPG_Foreground, 0.5f);
 		}
 
-		for (int32 i = 0; i < RuntimeNode->PlanarLimitsData.Num(); i++)
+		const TConstArrayView<FKawaiiPhysicsLimitInstance> Instances = RuntimeNode->GetPlanarLimitsDataInstances();
+		for (int32 i = 0; i < FMath::Min(RuntimeNode->GetPlanarLimitsDataDefinitions().Num(), Instances.Num()); i++)
 		{
-			auto& Plane = RuntimeNode->PlanarLimitsData[i];
-			FTransform PlaneTransform = FTransform(Plane.Rotation, Plane.Location);
+			auto& Plane = Instances[i];
+			FTransform PlaneTransform = FTransform(FQuat(Plane.Rotation), FVector(Plane.Location));
 			PlaneTransform.NormalizeRotation();
 
 			PDI->SetHitProxy(new HKawaiiPhysicsHitProxy(ECollisionLimitType::Planar, i, true));
@@ -285,11 +302,11 @@ void FKawaiiPhysicsEditMode::RenderBoneConstraint(FPrimitiveDrawInterface* PDI)
 			if (BoneConstraint.IsBoneReferenceValid() && !RuntimeNode->ModifyBones.IsEmpty())
 			{
 				FTransform BoneTransform1 = FTransform(
-					RuntimeNode->ModifyBones[BoneConstraint.ModifyBoneIndex1].PrevRotation,
-					RuntimeNode->ModifyBones[BoneConstraint.ModifyBoneIndex1].PrevLocation);
+					FQuat(RuntimeNode->ModifyBones[BoneConstraint.ModifyBoneIndex1].PrevRotation),
+					FVector(RuntimeNode->ModifyBones[BoneConstraint.ModifyBoneIndex1].PrevLocation));
 				FTransform BoneTransform2 = FTransform(
-					RuntimeNode->ModifyBones[BoneConstraint.ModifyBoneIndex2].PrevRotation,
-					RuntimeNode->ModifyBones[BoneConstraint.ModifyBoneIndex2].PrevLocation);
+					FQuat(RuntimeNode->ModifyBones[BoneConstraint.ModifyBoneIndex2].PrevRotation),
+					FVector(RuntimeNode->ModifyBones[BoneConstraint.ModifyBoneIndex2].PrevLocation));
 
 				// 1 -> 2
 				FVector Dir = (BoneTransform2.GetLocation() - BoneTransform1.GetLocation()).GetSafeNormal();
@@ -334,9 +351,11 @@ FVector FKawaiiPhysicsEditMode::GetWidgetLocation(ECollisionLimitType CollisionT
 		return GetAnimPreviewScene().GetPreviewMeshComponent()->GetComponentLocation();
 	}
 
-	if (const FCollisionLimitBase* Collision = GetSelectCollisionLimitRuntime())
+	FVector Location;
+	FQuat Rotation;
+	if (GetSelectCollisionTransform(Location, Rotation))
 	{
-		return Collision->Location;
+		return Location;
 	}
 
 	return GetAnimPreviewScene().GetPreviewMeshComponent()->GetComponentLocation();
@@ -354,13 +373,9 @@ bool FKawaiiPhysicsEditMode::GetCustomDrawingCoordinateSystem(FMatrix& InMatrix,
 		return false;
 	}
 
+	FVector Location;
 	FQuat Rotation = FQuat::Identity;
-
-	FCollisionLimitBase* Collision = GetSelectCollisionLimitRuntime();
-	if (Collision)
-	{
-		Rotation = Collision->Rotation;
-	}
+	GetSelectCollisionTransform(Location, Rotation);
 
 	InMatrix = FTransform(Rotation).ToMatrixNoScale();
 	return true;
@@ -518,9 +533,13 @@ void FKawaiiPhysicsEditMode::OnExternalNodePropertyChange(FPropertyChangedEvent&
 
 void FKawaiiPhysicsEditMode::OnLimitDataAssetPropertyChange(FPropertyChangedEvent& InPropertyEvent)
 {
-	GraphNode->Node.SphericalLimitsData = RuntimeNode->SphericalLimitsData;
-	GraphNode->Node.CapsuleLimitsData = RuntimeNode->CapsuleLimitsData;
-	GraphNode->Node.PlanarLimitsData = RuntimeNode->PlanarLimitsData;
+	// The node reads the limits from the asset : only the selection may have to be dropped
+	if (bIsSelectCollisionFromDataAsset && !IsValidSelectCollision())
+	{
+		SelectCollisionIndex = -1;
+		SelectCollisionType = ECollisionLimitType::None;
+		CurWidgetMode = UE_WIDGET::EWidgetMode::WM_None;
+	}
 }
 
 bool FKawaiiPhysicsEditMode::IsValidSelectCollision() const
@@ -531,19 +550,23 @@ bool FKawaiiPhysicsEditMode::IsValidSelectCollision() const
 		return false;
 	}
 
+	// The limits of a LimitsDataAsset are valid once the node has built their instances
 	switch (SelectCollisionType)
 	{
 	case ECollisionLimitType::Spherical:
 		return bIsSelectCollisionFromDataAsset
-			       ? RuntimeNode->SphericalLimitsData.IsValidIndex(SelectCollisionIndex)
+			       ? RuntimeNode->GetSphericalLimitsDataDefinitions().IsValidIndex(SelectCollisionIndex) &&
+			       RuntimeNode->GetSphericalLimitsDataInstances().IsValidIndex(SelectCollisionIndex)
 			       : RuntimeNode->SphericalLimits.IsValidIndex(SelectCollisionIndex);
 	case ECollisionLimitType::Capsule:
 		return bIsSelectCollisionFromDataAsset
-			       ? RuntimeNode->CapsuleLimitsData.IsValidIndex(SelectCollisionIndex)
+			       ? RuntimeNode->GetCapsuleLimitsDataDefinitions().IsValidIndex(SelectCollisionIndex) &&
+			       RuntimeNode->GetCapsuleLimitsDataInstances().IsValidIndex(SelectCollisionIndex)
 			       : RuntimeNode->CapsuleLimits.IsValidIndex(SelectCollisionIndex);
 	case ECollisionLimitType::Planar:
 		return bIsSelectCollisionFromDataAsset
-			       ? RuntimeNode->PlanarLimitsData.IsValidIndex(SelectCollisionIndex)
+			       ? RuntimeNode->GetPlanarLimitsDataDefinitions().IsValidIndex(SelectCollisionIndex) &&
+			       RuntimeNode->GetPlanarLimitsDataInstances().IsValidIndex(SelectCollisionIndex)
 			       : RuntimeNode->PlanarLimits.IsValidIndex(SelectCollisionIndex);
 	case ECollisionLimitType::None: break;
 	default: ;
@@ -558,19 +581,20 @@ FCollisionLimitBase* FKawaiiPhysicsEditMode::GetSelectCollisionLimitRuntime() co
 		return nullptr;
 	}
 
+	// The limits of a LimitsDataAsset are edited in the asset. UpdateLimit must be the last use of the pointer
 	switch (SelectCollisionType)
 	{
 	case ECollisionLimitType::Spherical:
 		return bIsSelectCollisionFromDataAsset
-			       ? &(RuntimeNode->SphericalLimitsData[SelectCollisionIndex])
+			       ? &(RuntimeNode->LimitsDataAsset->SphericalLimits[SelectCollisionIndex])
 			       : &(RuntimeNode->SphericalLimits[SelectCollisionIndex]);
 	case ECollisionLimitType::Capsule:
 		return bIsSelectCollisionFromDataAsset
-			       ? &(RuntimeNode->CapsuleLimitsData[SelectCollisionIndex])
+			       ? &(RuntimeNode->LimitsDataAsset->CapsuleLimits[SelectCollisionIndex])
 			       : &(RuntimeNode->CapsuleLimits[SelectCollisionIndex]);
 	case ECollisionLimitType::Planar:
 		return bIsSelectCollisionFromDataAsset
-			       ? &(RuntimeNode->PlanarLimitsData[SelectCollisionIndex])
+			       ? &(RuntimeNode->LimitsDataAsset->PlanarLimits[SelectCollisionIndex])
 			       : &(RuntimeNode->PlanarLimits[SelectCollisionIndex]);
 	case ECollisionLimitType::None: break;
 	default: ;
@@ -579,9 +603,49 @@ FCollisionLimitBase* FKawaiiPhysicsEditMode::GetSelectCollisionLimitRuntime() co
 	return nullptr;
 }
 
-FCollisionLimitBase* FKawaiiPhysicsEditMode::GetSelectCollisionLimitGraph() const
+bool FKawaiiPhysicsEditMode::GetSelectCollisionTransform(FVector& OutLocation, FQuat& OutRotation) const
 {
 	if (!IsValidSelectCollision())
+	{
+		return false;
+	}
+
+	if (bIsSelectCollisionFromDataAsset)
+	{
+		TConstArrayView<FKawaiiPhysicsLimitInstance> Instances;
+		switch (SelectCollisionType)
+		{
+		case ECollisionLimitType::Spherical:
+			Instances = RuntimeNode->GetSphericalLimitsDataInstances();
+			break;
+		case ECollisionLimitType::Capsule:
+			Instances = RuntimeNode->GetCapsuleLimitsDataInstances();
+			break;
+		case ECollisionLimitType::Planar:
+			Instances = RuntimeNode->GetPlanarLimitsDataInstances();
+			break;
+		default:
+			return false;
+		}
+		OutLocation = FVector(Instances[SelectCollisionIndex].Location);
+		OutRotation = FQuat(Instances[SelectCollisionIndex].Rotation);
+		return true;
+	}
+
+	const FCollisionLimitBase* Collision = GetSelectCollisionLimitRuntime();
+	if (!Collision)
+	{
+		return false;
+	}
+	OutLocation = FVector(Collision->Location);
+	OutRotation = FQuat(Collision->Rotation);
+	return true;
+}
+
+FCollisionLimitBase* FKawaiiPhysicsEditMode::GetSelectCollisionLimitGraph() const
+{
+	// The graph node has no copy of the limits of a LimitsDataAsset
+	if (!IsValidSelectCollision() || bIsSelectCollisionFromDataAsset)
 	{
 		return nullptr;
 	}
@@ -589,32 +653,17 @@ FCollisionLimitBase* FKawaiiPhysicsEditMode::GetSelectCollisionLimitGraph() cons
 	switch (SelectCollisionType)
 	{
 	case ECollisionLimitType::Spherical:
-		{
-			auto& CollisionLimits = bIsSelectCollisionFromDataAsset
-				                        ? GraphNode->Node.SphericalLimitsData
-				                        : GraphNode->Node.SphericalLimits;
-			return CollisionLimits.IsValidIndex(SelectCollisionIndex)
-				       ? &CollisionLimits[SelectCollisionIndex]
-				       : nullptr;
-		}
+		return GraphNode->Node.SphericalLimits.IsValidIndex(SelectCollisionIndex)
+			       ? &GraphNode->Node.SphericalLimits[SelectCollisionIndex]
+			       : nullptr;
 	case ECollisionLimitType::Capsule:
-		{
-			auto& CollisionLimits = bIsSelectCollisionFromDataAsset
-				                        ? GraphNode->Node.CapsuleLimitsData
-				                        : GraphNode->Node.CapsuleLimits;
-			return CollisionLimits.IsValidIndex(SelectCollisionIndex)
-				       ? &CollisionLimits[SelectCollisionIndex]
-				       : nullptr;
-		}
+		return GraphNode->Node.CapsuleLimits.IsValidIndex(SelectCollisionIndex)
+			       ? &GraphNode->Node.CapsuleLimits[SelectCollisionIndex]
+			       : nullptr;
 	case ECollisionLimitType::Planar:
-		{
-			auto& CollisionLimits = bIsSelectCollisionFromDataAsset
-				                        ? GraphNode->Node.PlanarLimitsData
-				                        : GraphNode->Node.PlanarLimits;
-			return CollisionLimits.IsValidIndex(SelectCollisionIndex)
-				       ? &CollisionLimits[SelectCollisionIndex]
-				       : nullptr;
-		}
+		return GraphNode->Node.PlanarLimits.IsValidIndex(SelectCollisionIndex)
+			       ? &GraphNode->Node.PlanarLimits[SelectCollisionIndex]
+			       : nullptr;
 	case ECollisionLimitType::None: break;
 	default: ;
 	}
@@ -631,7 +680,7 @@ void FKawaiiPhysicsEditMode::DoTranslation(FVector& InTranslation)
 
 	FCollisionLimitBase* CollisionRuntime = GetSelectCollisionLimitRuntime();
 	FCollisionLimitBase* CollisionGraph = GetSelectCollisionLimitGraph();
-	if (!CollisionRuntime || !CollisionGraph)
+	if (!CollisionRuntime || (!CollisionGraph && !bIsSelectCollisionFromDataAsset))
 	{
 		UE_LOG(LogKawaiiPhysics, Warning, TEXT( "Fail to edit limit." ));
 		if (bIsSelectCollisionFromDataAsset)
@@ -643,9 +692,9 @@ void FKawaiiPhysicsEditMode::DoTranslation(FVector& InTranslation)
 	}
 
 	FVector Offset;
-	if (CollisionRuntime->DrivingBone.BoneIndex >= 0)
+	const USkeletalMeshComponent* SkelComp = GetAnimPreviewScene().GetPreviewMeshComponent();
+	if (SkelComp->GetBoneIndex(CollisionRuntime->DrivingBone.BoneName) != INDEX_NONE)
 	{
-		const USkeletalMeshComponent* SkelComp = GetAnimPreviewScene().GetPreviewMeshComponent();
 		Offset = ConvertCSVectorToBoneSpace(SkelComp, InTranslation, RuntimeNode->ForwardedPose,
 		                                    CollisionRuntime->DrivingBone.BoneName, BCS_BoneSpace);
 	}
@@ -654,7 +703,10 @@ void FKawaiiPhysicsEditMode::DoTranslation(FVector& InTranslation)
 		Offset = InTranslation;
 	}
 	CollisionRuntime->OffsetLocation += Offset;
-	CollisionGraph->OffsetLocation = CollisionRuntime->OffsetLocation;
+	if (CollisionGraph)
+	{
+		CollisionGraph->OffsetLocation = CollisionRuntime->OffsetLocation;
+	}
 
 	if (bIsSelectCollisionFromDataAsset)
 	{
@@ -671,7 +723,7 @@ void FKawaiiPhysicsEditMode::DoRotation(FRotator& InRotation)
 
 	FCollisionLimitBase* CollisionRuntime = GetSelectCollisionLimitRuntime();
 	FCollisionLimitBase* CollisionGraph = GetSelectCollisionLimitGraph();
-	if (!CollisionRuntime || !CollisionGraph)
+	if (!CollisionRuntime || (!CollisionGraph && !bIsSelectCollisionFromDataAsset))
 	{
 		UE_LOG(LogKawaiiPhysics, Warning, TEXT( "Fail to edit limit." ));
 		if (bIsSelectCollisionFromDataAsset)
@@ -683,9 +735,9 @@ void FKawaiiPhysicsEditMode::DoRotation(FRotator& InRotation)
 	}
 
 	FQuat DeltaQuat;
-	if (CollisionRuntime->DrivingBone.BoneIndex >= 0)
+	const USkeletalMeshComponent* SkelComp = GetAnimPreviewScene().GetPreviewMeshComponent();
+	if (SkelComp->GetBoneIndex(CollisionRuntime->DrivingBone.BoneName) != INDEX_NONE)
 	{
-		const USkeletalMeshComponent* SkelComp = GetAnimPreviewScene().GetPreviewMeshComponent();
 		DeltaQuat = ConvertCSRotationToBoneSpace(SkelComp, InRotation, RuntimeNode->ForwardedPose,
 		                                         CollisionRuntime->DrivingBone.BoneName, BCS_BoneSpace);
 	}
@@ -695,7 +747,10 @@ void FKawaiiPhysicsEditMode::DoRotation(FRotator& InRotation)
 	}
 
 	CollisionRuntime->OffsetRotation = FRotator(DeltaQuat * CollisionRuntime->OffsetRotation.Quaternion());
-	CollisionGraph->OffsetRotation = CollisionRuntime->OffsetRotation;
+	if (CollisionGraph)
+	{
+		CollisionGraph->OffsetRotation = CollisionRuntime->OffsetRotation;
+	}
 
 	if (bIsSelectCollisionFromDataAsset)
 	{
@@ -711,7 +766,7 @@ void FKawaiiPhysicsEditMode::DoScale(FVector& InScale)
 	}
 	FCollisionLimitBase* CollisionRuntime = GetSelectCollisionLimitRuntime();
 	FCollisionLimitBase* CollisionGraph = GetSelectCollisionLimitGraph();
-	if (!CollisionRuntime || !CollisionGraph)
+	if (!CollisionRuntime || (!CollisionGraph && !bIsSelectCollisionFromDataAsset))
 	{
 		UE_LOG(LogKawaiiPhysics, Warning, TEXT( "Fail to edit limit." ));
 		if (bIsSelectCollisionFromDataAsset)
@@ -725,14 +780,16 @@ void FKawaiiPhysicsEditMode::DoScale(FVector& InScale)
 	if (SelectCollisionType == ECollisionLimitType::Spherical)
 	{
 		FSphericalLimit& SphericalLimitRuntime = *static_cast<FSphericalLimit*>(CollisionRuntime);
-		FSphericalLimit& SphericalLimitGraph = *static_cast<FSphericalLimit*>(CollisionGraph);
 
 		SphericalLimitRuntime.Radius += InScale.X;
 		SphericalLimitRuntime.Radius += InScale.Y;
 		SphericalLimitRuntime.Radius += InScale.Z;
 		SphericalLimitRuntime.Radius = FMath::Max(SphericalLimitRuntime.Radius, 0.0f);
 
-		SphericalLimitGraph.Radius = SphericalLimitRuntime.Radius;
+		if (FSphericalLimit* SphericalLimitGraph = static_cast<FSphericalLimit*>(CollisionGraph))
+		{
+			SphericalLimitGraph->Radius = SphericalLimitRuntime.Radius;
+		}
 
 		if (bIsSelectCollisionFromDataAsset)
 		{
@@ -742,7 +799,6 @@ void FKawaiiPhysicsEditMode::DoScale(FVector& InScale)
 	else if (SelectCollisionType == ECollisionLimitType::Capsule)
 	{
 		FCapsuleLimit& CapsuleLimitRuntime = *static_cast<FCapsuleLimit*>(CollisionRuntime);
-		FCapsuleLimit& CapsuleLimitGraph = *static_cast<FCapsuleLimit*>(CollisionGraph);
 
 		CapsuleLimitRuntime.Radius += InScale.X;
 		CapsuleLimitRuntime.Radius += InScale.Y;
@@ -751,8 +807,11 @@ void FKawaiiPhysicsEditMode::DoScale(FVector& InScale)
 		CapsuleLimitRuntime.Length += InScale.Z;
 		CapsuleLimitRuntime.Length = FMath::Max(CapsuleLimitRuntime.Length, 0.0f);
 
-		CapsuleLimitGraph.Radius = CapsuleLimitRuntime.Radius;
-		CapsuleLimitGraph.Length = CapsuleLimitRuntime.Length;
+		if (FCapsuleLimit* CapsuleLimitGraph = static_cast<FCapsuleLimit*>(CollisionGraph))
+		{
+			CapsuleLimitGraph->Radius = CapsuleLimitRuntime.Radius;
+			CapsuleLimitGraph->Length = CapsuleLimitRuntime.Length;
+		}
 
 		if (bIsSelectCollisionFromDataAsset)
 		{
@@ -824,7 +883,7 @@ void FKawaiiPhysicsEditMode::DrawHUD(FEditorViewportClient* ViewportClient, FVie
 			for (auto& Bone : RuntimeNode->ModifyBones)
 			{
 				// Refer to FAnimationViewportClient::ShowBoneNames
-				const FVector BonePos = PreviewMeshComponent->GetComponentTransform().TransformPosition(Bone.Location);
+				const FVector BonePos = PreviewMeshComponent->GetComponentTransform().TransformPosition(FVector(Bone.Location));
 				Draw3DTextItem(FText::AsNumber(Bone.LengthFromRoot / RuntimeNode->GetTotalBoneLength()), Canvas, View,
 				               Viewport, BonePos);
 			}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "KawaiiPhysicsBakeLibrary.generated.h"
+
+class UAnimBlueprint;
+class UAnimSequence;
+class USkeletalMesh;
+
+USTRUCT(BlueprintType)
+struct FKawaiiPhysicsBakeSettings
+{
+	GENERATED_BODY()
+
+	/**
+	* シミュレーションに使用するSkeletalMesh
+	* Skeletal mesh to simulate
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake")
+	TObjectPtr<USkeletalMesh> SkeletalMesh;
+
+	/**
+	* KawaiiPhysicsノードを含むAnimBlueprint。PostProcess AnimBPとしてソースアニメーションの上で実行されます
+	* AnimBlueprint containing KawaiiPhysics nodes. It runs as the post process AnimBP on top of the source animations
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake")
+	TObjectPtr<UAnimBlueprint> AnimBlueprint;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake")
+	TArray<TObjectPtr<UAnimSequence>> SourceAnimations;
+
+	/**
+	* 出力先のフォルダ (例: /Game/Baked)。空の場合はソースアニメーションと同じフォルダ
+	* Folder of the baked assets (e.g. /Game/Baked). Next to each source animation if empty
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake")
+	FString OutputPath;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake")
+	FString Suffix = TEXT("_KawaiiPhysics");
+
+	/**
+	* ソースアニメーションとの差分のみを加算アニメーションとして出力
+	* Write an additive animation holding only the difference from the source animation
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake")
+	bool bAdditive = false;
+
+	/**
+	* ループしないアニメーション：最初のフレームを保持して揺れを落ち着かせる時間
+	* Non looping animations : time the first frame is held so that the chains settle
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake", meta = (ClampMin = "0"))
+	float WarmUpTime = 1.0f;
+
+	/**
+	* ループするアニメーション：ループの始点で揺れが収束するまで再生する最大ループ回数
+	* Looping animations : maximum number of cycles played until the chains reach the same state at each loop start
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake", meta = (ClampMin = "1"))
+	int32 MaxWarmUpLoops = 8;
+
+	/**
+	* ループの始点でのボーン位置の差がこの値(cm)未満になったら収束とみなす
+	* The loop is steady once no simulated bone moves more than this (cm) between two loop starts
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Bake", meta = (ClampMin = "0"))
+	float SteadyStateTolerance = 0.1f;
+};
+
+/**
+ * KawaiiPhysicsのシミュレーション結果をAnimSequenceにベイクするエディタ機能
+ * Bakes the KawaiiPhysics simulation into animation sequences, so that distant or crowd characters
+ * can play the baked motion with the node disabled (e.g. with its LODThreshold)
+ */
+UCLASS()
+class UKawaiiPhysicsBakeLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	* 各ソースアニメーションをシミュレーションし、KawaiiPhysicsのボーンを書き込んだ新しいAnimSequenceを作成します。アセットは未保存です
+	* Simulates each source animation offline and creates a new sequence with the KawaiiPhysics bones written in.
+	* The new assets are created dirty, not saved
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Kawaii Physics|Bake")
+	static TArray<UAnimSequence*> BakeKawaiiPhysics(const FKawaiiPhysicsBakeSettings& Settings);
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UBlueprint;
+
+namespace KawaiiPhysicsBlueprintMigration
+{
+	/**
+	* Blueprintに公開されなくなったFKawaiiPhysicsModifyBoneのメンバーを、UKawaiiPhysicsLibraryの関数呼び出しに置き換えます
+	* Replace the FKawaiiPhysicsModifyBone members that are no longer Blueprint visible
+	* (Location, PrevLocation, PoseLocation/Rotation/Scale, ChildIndexs) used by Break/Set Members nodes
+	* with UKawaiiPhysicsLibrary calls, connecting their Node pin to the node parameter of the function.
+	* Returns the number of replaced pins
+	*/
+	int32 MigrateModifyBonePins(UBlueprint* Blueprint);
+
+	/** Migrate every Blueprint before it is compiled. KawaiiPhysics.MigrateModifyBoneBlueprints migrates them all */
+	void Register();
+	void Unregister();
+}
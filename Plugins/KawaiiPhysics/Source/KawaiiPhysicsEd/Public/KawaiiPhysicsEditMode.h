@@ -69,6 +69,9 @@ private:
 	FCollisionLimitBase* GetSelectCollisionLimitRuntime() const;
 	FCollisionLimitBase* GetSelectCollisionLimitGraph() const;
 
+	/** Evaluated transform of the selected collision. LimitsDataAsset ones keep it in the node's instances */
+	bool GetSelectCollisionTransform(FVector& OutLocation, FQuat& OutRotation) const;
+
 	/** Draw text func for DrawHUD */
 	void DrawTextItem(const FText& Text, FCanvas* Canvas, float X, float& Y, float FontHeight);
 	void Draw3DTextItem(const FText& Text, FCanvas* Canvas, const FSceneView* View, const FViewport* Viewport,
@@ -0,0 +1,14 @@
+using UnrealBuildTool;
+
+public class KawaiiPhysicsTests : ModuleRules
+{
+	public KawaiiPhysicsTests(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PrivateDependencyModuleNames.AddRange(new[]
+		{
+			"Core", "CoreUObject", "Engine", "AnimGraphRuntime", "StructUtils", "Json", "KawaiiPhysics"
+		});
+	}
+}
@@ -0,0 +1,512 @@
+#include "KawaiiPhysicsBenchmarkCommandlet.h"
+
+#include "AnimNode_KawaiiPhysics.h"
+#include "Animation/AnimBlueprint.h"
+#include "Animation/AnimClassInterface.h"
+#include "Animation/AnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Dom/JsonObject.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Runtime/Launch/Resources/Version.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(KawaiiPhysicsBenchmarkCommandlet)
+
+DEFINE_LOG_CATEGORY_STATIC(LogKawaiiPhysicsBenchmark, Log, All);
+
+#if WITH_EDITOR
+namespace KawaiiPhysicsBenchmark
+{
+	const TCHAR* const DefaultAnimBlueprints[] =
+	{
+		TEXT("/Game/KawaiiPhysicsSample/GrayChan/ABP_GC_Skirt.ABP_GC_Skirt"),
+		TEXT("/Game/KawaiiPhysicsSample/GrayChan/ABP_GC_KawaiiPhysics.ABP_GC_KawaiiPhysics"),
+		TEXT("/Game/KawaiiPhysicsSample/GrayChan/ABP_GC_ExternalForce.ABP_GC_ExternalForce"),
+		TEXT("/Game/KawaiiPhysicsSample/Chain/ABP_Chain_KawaiiPhysics_Collision0.ABP_Chain_KawaiiPhysics_Collision0"),
+		TEXT("/Game/KawaiiPhysicsSample/Chain/ABP_Chain_KawaiiPhysics_Collision1.ABP_Chain_KawaiiPhysics_Collision1"),
+		TEXT("/Game/KawaiiPhysicsSample/Chain/ABP_Chain_KawaiiPhysics_Collision2.ABP_Chain_KawaiiPhysics_Collision2"),
+		TEXT(
+			"/Game/KawaiiPhysicsSample/Chain/ABP_Chain_KawaiiPhysics_Collision_World.ABP_Chain_KawaiiPhysics_Collision_World"),
+	};
+
+	/** Timings of one stage over all measured frames (microseconds) */
+	struct FStageTimings
+	{
+		FString Name;
+		TArray<double> Samples;
+
+		double GetMean() const
+		{
+			double Sum = 0.0;
+			for (const double Sample : Samples)
+			{
+				Sum += Sample;
+			}
+			return Samples.Num() > 0 ? Sum / Samples.Num() : 0.0;
+		}
+
+		double GetPercentile(double Rate) const
+		{
+			if (Samples.IsEmpty())
+			{
+				return 0.0;
+			}
+			TArray<double> Sorted = Samples;
+			Sorted.Sort();
+			return Sorted[FMath::Clamp(FMath::FloorToInt32(Rate * (Sorted.Num() - 1)), 0, Sorted.Num() - 1)];
+		}
+	};
+
+	struct FBenchmarkResult
+	{
+		FString AnimBlueprint;
+		FString Mesh;
+		int32 NumNodes = 0;
+		int32 NumBones = 0;
+		int32 NumSegments = 0;
+		bool bSegmentCollision = false;
+		// Sizes of the state of all nodes, 0 without -SnapshotState
+		int32 StateBytes = 0;
+		int32 QuantizedStateBytes = 0;
+		TArray<FStageTimings> Stages;
+		int64 UsedPhysicalDelta = 0;
+		uint64 PeakUsedPhysical = 0;
+	};
+
+	/** Scripted root motion : walk forward while swaying and turning */
+	FTransform GetRootTransform(int32 Frame, float DeltaTime)
+	{
+		const float Time = Frame * DeltaTime;
+		return FTransform(FRotator(0, 90.0f * FMath::Sin(Time * 1.5f), 0),
+		                  FVector(150.0f * Time, 40.0f * FMath::Sin(Time * 4.0f), 10.0f * FMath::Abs(FMath::Sin(Time * 8.0f))));
+	}
+
+	template <typename FuncType>
+	void ForEachKawaiiPhysicsNode(UAnimInstance* AnimInstance, FuncType Func)
+	{
+		const IAnimClassInterface* AnimClass = IAnimClassInterface::GetFromClass(AnimInstance->GetClass());
+		if (!AnimClass)
+		{
+			return;
+		}
+		for (const FStructProperty* Property : AnimClass->GetAnimNodeProperties())
+		{
+			if (Property->Struct->IsChildOf(FAnimNode_KawaiiPhysics::StaticStruct()))
+			{
+				Func(*Property->ContainerPtrToValuePtr<FAnimNode_KawaiiPhysics>(AnimInstance));
+			}
+		}
+	}
+
+	void CountKawaiiPhysicsNodes(UAnimInstance* AnimInstance, int32& OutNumNodes, int32& OutNumBones,
+	                             int32& OutNumSegments)
+	{
+		OutNumNodes = 0;
+		OutNumBones = 0;
+		OutNumSegments = 0;
+
+		ForEachKawaiiPhysicsNode(AnimInstance, [&](const FAnimNode_KawaiiPhysics& Node)
+		{
+			OutNumNodes++;
+			OutNumBones += Node.ModifyBones.Num();
+			for (const FKawaiiPhysicsModifyBone& Bone : Node.ModifyBones)
+			{
+				if (Bone.ParentIndex >= 0)
+				{
+					OutNumSegments++;
+				}
+			}
+		});
+	}
+
+	bool RunBenchmark(UWorld* World, const FString& AnimBlueprintPath, int32 WarmUpFrames, int32 Frames,
+	                  float DeltaTime, bool bSegmentCollision, bool bSnapshotState, FBenchmarkResult& OutResult)
+	{
+		const UAnimBlueprint* AnimBlueprint = LoadObject<UAnimBlueprint>(nullptr, *AnimBlueprintPath);
+		if (!AnimBlueprint || !AnimBlueprint->GeneratedClass)
+		{
+			UE_LOG(LogKawaiiPhysicsBenchmark, Error, TEXT("Failed to load AnimBlueprint %s"), *AnimBlueprintPath);
+			return false;
+		}
+
+		USkeletalMesh* Mesh = AnimBlueprint->GetPreviewMesh(true);
+		if (!Mesh)
+		{
+			UE_LOG(LogKawaiiPhysicsBenchmark, Error, TEXT("%s has no preview mesh"), *AnimBlueprintPath);
+			return false;
+		}
+
+		USkeletalMeshComponent* SkelComp = NewObject<USkeletalMeshComponent>(GetTransientPackage());
+		SkelComp->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+		SkelComp->bEnableUpdateRateOptimizations = false;
+#if	ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 1
+		SkelComp->SetSkeletalMeshAsset(Mesh);
+#else
+		SkelComp->SetSkeletalMesh(Mesh);
+#endif
+		SkelComp->SetAnimInstanceClass(AnimBlueprint->GeneratedClass);
+		SkelComp->RegisterComponentWithWorld(World);
+
+		UAnimInstance* AnimInstance = SkelComp->GetAnimInstance();
+		if (!AnimInstance)
+		{
+			UE_LOG(LogKawaiiPhysicsBenchmark, Error, TEXT("Failed to create AnimInstance for %s"), *AnimBlueprintPath);
+			SkelComp->UnregisterComponent();
+			return false;
+		}
+
+		OutResult.AnimBlueprint = AnimBlueprintPath;
+		OutResult.Mesh = Mesh->GetPathName();
+		OutResult.bSegmentCollision = bSegmentCollision;
+
+		if (bSegmentCollision)
+		{
+			ForEachKawaiiPhysicsNode(AnimInstance, [](FAnimNode_KawaiiPhysics& Node)
+			{
+				Node.bUseSegmentCollision = true;
+			});
+		}
+
+		OutResult.Stages.SetNum(3);
+		FStageTimings& Update = OutResult.Stages[0];
+		Update.Name = TEXT("Update");
+		FStageTimings& Evaluate = OutResult.Stages[1];
+		Evaluate.Name = TEXT("Evaluate");
+		FStageTimings& Total = OutResult.Stages[2];
+		Total.Name = TEXT("Total");
+		// Outside of Total : the game decides when to snapshot
+		if (bSnapshotState)
+		{
+			OutResult.Stages.SetNum(6);
+			OutResult.Stages[3].Name = TEXT("SaveState");
+			OutResult.Stages[4].Name = TEXT("SaveStateQuantized");
+			OutResult.Stages[5].Name = TEXT("RestoreState");
+		}
+		for (FStageTimings& Stage : OutResult.Stages)
+		{
+			Stage.Samples.Reserve(Frames);
+		}
+
+		const auto TickFrame = [&](int32 Frame, bool bRecord)
+		{
+			SkelComp->SetWorldTransform(GetRootTransform(Frame, DeltaTime));
+
+			const double StartTime = FPlatformTime::Seconds();
+			SkelComp->TickAnimation(DeltaTime, false);
+			const double UpdatedTime = FPlatformTime::Seconds();
+			// No tick function : evaluation and PostAnimEvaluation run inline on this thread
+			SkelComp->RefreshBoneTransforms();
+			const double EndTime = FPlatformTime::Seconds();
+
+			if (bRecord)
+			{
+				Update.Samples.Add((UpdatedTime - StartTime) * 1e6);
+				Evaluate.Samples.Add((EndTime - UpdatedTime) * 1e6);
+				Total.Samples.Add((EndTime - StartTime) * 1e6);
+			}
+		};
+
+		TArray<TArray<uint8>> States;
+		TArray<uint8> QuantizedState;
+		const auto SnapshotState = [&]()
+		{
+			TArray<FAnimNode_KawaiiPhysics*> Nodes;
+			ForEachKawaiiPhysicsNode(AnimInstance, [&Nodes](FAnimNode_KawaiiPhysics& Node)
+			{
+				Nodes.Add(&Node);
+			});
+			States.SetNum(Nodes.Num());
+
+			double StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Nodes.Num(); ++i)
+			{
+				Nodes[i]->SaveState(States[i]);
+			}
+			double EndTime = FPlatformTime::Seconds();
+			OutResult.Stages[3].Samples.Add((EndTime - StartTime) * 1e6);
+
+			OutResult.QuantizedStateBytes = 0;
+			StartTime = FPlatformTime::Seconds();
+			for (FAnimNode_KawaiiPhysics* Node : Nodes)
+			{
+				Node->SaveState(QuantizedState, true);
+				OutResult.QuantizedStateBytes += QuantizedState.Num();
+			}
+			EndTime = FPlatformTime::Seconds();
+			OutResult.Stages[4].Samples.Add((EndTime - StartTime) * 1e6);
+
+			// Restoring the state just saved leaves the simulation unchanged
+			OutResult.StateBytes = 0;
+			StartTime = FPlatformTime::Seconds();
+			for (int32 i = 0; i < Nodes.Num(); ++i)
+			{
+				Nodes[i]->RestoreState(States[i]);
+				OutResult.StateBytes += States[i].Num();
+			}
+			EndTime = FPlatformTime::Seconds();
+			OutResult.Stages[5].Samples.Add((EndTime - StartTime) * 1e6);
+		};
+
+		int32 Frame = 0;
+		for (; Frame < WarmUpFrames; ++Frame)
+		{
+			TickFrame(Frame, false);
+		}
+
+		const uint64 StartUsedPhysical = FPlatformMemory::GetStats().UsedPhysical;
+		for (int32 i = 0; i < Frames; ++i, ++Frame)
+		{
+			TickFrame(Frame, true);
+			if (bSnapshotState)
+			{
+				SnapshotState();
+			}
+			OutResult.PeakUsedPhysical = FMath::Max<uint64>(OutResult.PeakUsedPhysical,
+			                                                FPlatformMemory::GetStats().UsedPhysical);
+		}
+		OutResult.UsedPhysicalDelta = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) -
+			static_cast<int64>(StartUsedPhysical);
+
+		CountKawaiiPhysicsNodes(AnimInstance, OutResult.NumNodes, OutResult.NumBones, OutResult.NumSegments);
+
+		SkelComp->UnregisterComponent();
+		SkelComp->MarkAsGarbage();
+
+		return true;
+	}
+
+	FString MakeBaselineKey(const FString& AnimBlueprint, const FString& Stage)
+	{
+		return AnimBlueprint + TEXT("|") + Stage;
+	}
+
+	// ns/bone of a previous report keyed by AnimBlueprint and stage
+	bool LoadBaseline(const FString& BaselinePath, TMap<FString, double>& OutNsPerBone)
+	{
+		FString JsonString;
+		if (!FFileHelper::LoadFileToString(JsonString, *BaselinePath))
+		{
+			UE_LOG(LogKawaiiPhysicsBenchmark, Error, TEXT("Failed to load baseline report %s"), *BaselinePath);
+			return false;
+		}
+
+		TSharedPtr<FJsonObject> Root;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), Root) || !Root.IsValid())
+		{
+			UE_LOG(LogKawaiiPhysicsBenchmark, Error, TEXT("Failed to parse baseline report %s"), *BaselinePath);
+			return false;
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* JsonResults = nullptr;
+		if (!Root->TryGetArrayField(TEXT("Results"), JsonResults))
+		{
+			return false;
+		}
+
+		for (const TSharedPtr<FJsonValue>& JsonResultValue : *JsonResults)
+		{
+			const TSharedPtr<FJsonObject> JsonResult = JsonResultValue->AsObject();
+			const TSharedPtr<FJsonObject>* JsonStages = nullptr;
+			if (!JsonResult.IsValid() || !JsonResult->TryGetObjectField(TEXT("Stages"), JsonStages))
+			{
+				continue;
+			}
+
+			const FString AnimBlueprint = JsonResult->GetStringField(TEXT("AnimBlueprint"));
+			for (const auto& JsonStage : (*JsonStages)->Values)
+			{
+				double NsPerBone = 0.0;
+				if (JsonStage.Value->AsObject()->TryGetNumberField(TEXT("NsPerBone"), NsPerBone))
+				{
+					OutNsPerBone.Add(MakeBaselineKey(AnimBlueprint, JsonStage.Key), NsPerBone);
+				}
+			}
+		}
+		return true;
+	}
+
+	void WriteReport(const FString& ReportPath, const TArray<FBenchmarkResult>& Results, int32 Frames,
+	                 float DeltaTime, const TMap<FString, double>& Baseline)
+	{
+		const TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetNumberField(TEXT("Frames"), Frames);
+		Root->SetNumberField(TEXT("DeltaTime"), DeltaTime);
+
+		FString Csv = TEXT(
+			"AnimBlueprint,Mesh,Nodes,Bones,Stage,MeanUs,MinUs,MedianUs,P95Us,MaxUs,NsPerBone,UsedPhysicalDeltaKB,PeakUsedPhysicalMB,BaselineNsPerBone,NsPerBoneDeltaPercent\n");
+
+		TArray<TSharedPtr<FJsonValue>> JsonResults;
+		for (const FBenchmarkResult& Result : Results)
+		{
+			const TSharedRef<FJsonObject> JsonResult = MakeShared<FJsonObject>();
+			JsonResult->SetStringField(TEXT("AnimBlueprint"), Result.AnimBlueprint);
+			JsonResult->SetStringField(TEXT("Mesh"), Result.Mesh);
+			JsonResult->SetNumberField(TEXT("Nodes"), Result.NumNodes);
+			JsonResult->SetNumberField(TEXT("Bones"), Result.NumBones);
+			JsonResult->SetNumberField(TEXT("Segments"), Result.NumSegments);
+			JsonResult->SetBoolField(TEXT("SegmentCollision"), Result.bSegmentCollision);
+			if (Result.StateBytes > 0)
+			{
+				JsonResult->SetNumberField(TEXT("StateBytes"), Result.StateBytes);
+				JsonResult->SetNumberField(TEXT("QuantizedStateBytes"), Result.QuantizedStateBytes);
+				JsonResult->SetNumberField(TEXT("QuantizedStateBytesPerBone"),
+				                           Result.NumBones > 0
+					                           ? static_cast<double>(Result.QuantizedStateBytes) / Result.NumBones
+					                           : 0.0);
+			}
+			JsonResult->SetNumberField(TEXT("UsedPhysicalDeltaKB"), Result.UsedPhysicalDelta / 1024.0);
+			JsonResult->SetNumberField(TEXT("PeakUsedPhysicalMB"), Result.PeakUsedPhysical / (1024.0 * 1024.0));
+
+			const TSharedRef<FJsonObject> JsonStages = MakeShared<FJsonObject>();
+			for (const FStageTimings& Stage : Result.Stages)
+			{
+				const double Mean = Stage.GetMean();
+				const double Min = Stage.GetPercentile(0.0);
+				const double Median = Stage.GetPercentile(0.5);
+				const double P95 = Stage.GetPercentile(0.95);
+				const double Max = Stage.GetPercentile(1.0);
+				const double NsPerBone = Result.NumBones > 0 ? Mean * 1e3 / Result.NumBones : 0.0;
+				const double* BaselineNsPerBone = Baseline.Find(MakeBaselineKey(Result.AnimBlueprint, Stage.Name));
+				const double DeltaPercent = BaselineNsPerBone && *BaselineNsPerBone > 0.0
+					                            ? (NsPerBone / *BaselineNsPerBone - 1.0) * 100.0
+					                            : 0.0;
+
+				const TSharedRef<FJsonObject> JsonStage = MakeShared<FJsonObject>();
+				JsonStage->SetNumberField(TEXT("MeanUs"), Mean);
+				JsonStage->SetNumberField(TEXT("MinUs"), Min);
+				JsonStage->SetNumberField(TEXT("MedianUs"), Median);
+				JsonStage->SetNumberField(TEXT("P95Us"), P95);
+				JsonStage->SetNumberField(TEXT("MaxUs"), Max);
+				JsonStage->SetNumberField(TEXT("NsPerBone"), NsPerBone);
+				if (BaselineNsPerBone)
+				{
+					JsonStage->SetNumberField(TEXT("BaselineNsPerBone"), *BaselineNsPerBone);
+					JsonStage->SetNumberField(TEXT("NsPerBoneDeltaPercent"), DeltaPercent);
+					// Against a point collision baseline of the same AnimBlueprint : the cost of each segment test
+					if (Result.bSegmentCollision && Result.NumSegments > 0)
+					{
+						JsonStage->SetNumberField(TEXT("AddedNsPerSegment"),
+						                          (NsPerBone - *BaselineNsPerBone) * Result.NumBones / Result.NumSegments);
+					}
+				}
+				JsonStages->SetObjectField(Stage.Name, JsonStage);
+
+				Csv += FString::Printf(TEXT("%s,%s,%d,%d,%s,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.1f,%s,%s\n"),
+				                       *Result.AnimBlueprint, *Result.Mesh, Result.NumNodes, Result.NumBones,
+				                       *Stage.Name, Mean, Min, Median, P95, Max, NsPerBone,
+				                       Result.UsedPhysicalDelta / 1024.0,
+				                       Result.PeakUsedPhysical / (1024.0 * 1024.0),
+				                       BaselineNsPerBone ? *FString::Printf(TEXT("%.3f"), *BaselineNsPerBone) : TEXT(""),
+				                       BaselineNsPerBone ? *FString::Printf(TEXT("%.1f"), DeltaPercent) : TEXT(""));
+
+				if (BaselineNsPerBone)
+				{
+					UE_LOG(LogKawaiiPhysicsBenchmark, Display,
+					       TEXT("%s [%s] mean %.2f us, p95 %.2f us, %.2f ns/bone (baseline %.2f ns/bone, %+.1f%%)"),
+					       *Result.AnimBlueprint, *Stage.Name, Mean, P95, NsPerBone, *BaselineNsPerBone, DeltaPercent);
+				}
+				else
+				{
+					UE_LOG(LogKawaiiPhysicsBenchmark, Display, TEXT("%s [%s] mean %.2f us, p95 %.2f us, %.2f ns/bone"),
+					       *Result.AnimBlueprint, *Stage.Name, Mean, P95, NsPerBone);
+				}
+			}
+			JsonResult->SetObjectField(TEXT("Stages"), JsonStages);
+			JsonResults.Add(MakeShared<FJsonValueObject>(JsonResult));
+		}
+		Root->SetArrayField(TEXT("Results"), JsonResults);
+
+		FString JsonString;
+		FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&JsonString));
+		FFileHelper::SaveStringToFile(JsonString, *(ReportPath + TEXT(".json")));
+		FFileHelper::SaveStringToFile(Csv, *(ReportPath + TEXT(".csv")));
+
+		UE_LOG(LogKawaiiPhysicsBenchmark, Display, TEXT("Report written to %s.json/.csv"), *ReportPath);
+	}
+}
+#endif
+
+UKawaiiPhysicsBenchmarkCommandlet::UKawaiiPhysicsBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UKawaiiPhysicsBenchmarkCommandlet::Main(const FString& Params)
+{
+#if WITH_EDITOR
+	using namespace KawaiiPhysicsBenchmark;
+
+	int32 Frames = 600;
+	int32 WarmUpFrames = 60;
+	float DeltaTime = 1.0f / 60.0f;
+	FString AnimBlueprintsParam;
+	FString ReportPath = FPaths::ProjectSavedDir() / TEXT("Profiling/KawaiiPhysics/Benchmark");
+
+	FParse::Value(*Params, TEXT("Frames="), Frames);
+	FParse::Value(*Params, TEXT("WarmUp="), WarmUpFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), DeltaTime);
+	FParse::Value(*Params, TEXT("Report="), ReportPath);
+	const bool bSegmentCollision = FParse::Param(*Params, TEXT("SegmentCollision"));
+	const bool bSnapshotState = FParse::Param(*Params, TEXT("SnapshotState"));
+
+	TMap<FString, double> Baseline;
+	FString BaselinePath;
+	if (FParse::Value(*Params, TEXT("Compare="), BaselinePath) && !LoadBaseline(BaselinePath, Baseline))
+	{
+		return 1;
+	}
+
+	TArray<FString> AnimBlueprintPaths;
+	if (FParse::Value(*Params, TEXT("AnimBlueprints="), AnimBlueprintsParam, false))
+	{
+		AnimBlueprintsParam.ParseIntoArray(AnimBlueprintPaths, TEXT("+"));
+	}
+	else
+	{
+		AnimBlueprintPaths.Append(DefaultAnimBlueprints, UE_ARRAY_COUNT(DefaultAnimBlueprints));
+	}
+
+	if (Frames <= 0 || DeltaTime <= 0.0f)
+	{
+		UE_LOG(LogKawaiiPhysicsBenchmark, Error, TEXT("Frames and DeltaTime must be positive"));
+		return 1;
+	}
+
+	// Components need a world to initialize their AnimInstance, but nothing is rendered
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("KawaiiPhysicsBenchmark"));
+
+	TArray<FBenchmarkResult> Results;
+	bool bAllSucceeded = true;
+	for (const FString& Path : AnimBlueprintPaths)
+	{
+		FBenchmarkResult Result;
+		if (RunBenchmark(World, Path, WarmUpFrames, Frames, DeltaTime, bSegmentCollision, bSnapshotState, Result))
+		{
+			Results.Add(MoveTemp(Result));
+		}
+		else
+		{
+			bAllSucceeded = false;
+		}
+	}
+
+	World->DestroyWorld(false);
+
+	WriteReport(ReportPath, Results, Frames, DeltaTime, Baseline);
+
+	return bAllSucceeded ? 0 : 1;
+#else
+	UE_LOG(LogKawaiiPhysicsBenchmark, Error, TEXT("KawaiiPhysicsBenchmark requires an editor build"));
+	return 1;
+#endif
+}
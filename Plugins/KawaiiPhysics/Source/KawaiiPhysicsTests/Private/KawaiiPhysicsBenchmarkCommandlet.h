@@ -0,0 +1,33 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "KawaiiPhysicsBenchmarkCommandlet.generated.h"
+
+/**
+ * サンプルのAnimBlueprintを一定フレーム数Tick/Evaluateして処理時間を計測するコマンドレット
+ * Loads the sample AnimBlueprints with their preview meshes, ticks/evaluates them for a fixed number of frames
+ * with scripted root motion and writes a JSON/CSV report of per-stage timings and memory.
+ *
+ * UnrealEditor-Cmd <Project> -run=KawaiiPhysicsBenchmark -nullrhi
+ *  -AnimBlueprints=<path>+<path>  AnimBlueprints to run (default : samples in /Game/KawaiiPhysicsSample)
+ *  -Frames=<num>                  measured frames (default : 600)
+ *  -WarmUp=<num>                  frames before measuring (default : 60)
+ *  -DeltaTime=<sec>               fixed delta time (default : 1/60)
+ *  -Report=<path>                 report path without extension (default : Saved/Profiling/KawaiiPhysics/Benchmark)
+ *  -Compare=<path>                previous .json report : adds baseline ns/bone and the delta in percent
+ *  -SegmentCollision              enables bUseSegmentCollision on every KawaiiPhysics node. Compared against a run
+ *                                 without it, the report adds the extra ns per segment over point collision
+ *  -SnapshotState                 after each measured frame, saves (full and quantized) and restores the state of
+ *                                 every node : adds SaveState/SaveStateQuantized/RestoreState stages and the state size
+ */
+UCLASS()
+class UKawaiiPhysicsBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UKawaiiPhysicsBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,171 @@
+#include "KawaiiPhysicsTestRig.h"
+
+#include "Animation/Skeleton.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+int32 FKawaiiPhysicsTestSkeletonDesc::AddBone(const FName& Name, int32 ParentIndex, const FVector& LocalOffset)
+{
+	FBone& Bone = Bones.AddDefaulted_GetRef();
+	Bone.Name = Name;
+	Bone.ParentIndex = ParentIndex;
+	Bone.LocalTransform = FTransform(LocalOffset);
+	return Bones.Num() - 1;
+}
+
+FKawaiiPhysicsTestSkeletonDesc FKawaiiPhysicsTestSkeletonDesc::MakeSingleChain(int32 NumBones, float BoneLength)
+{
+	FKawaiiPhysicsTestSkeletonDesc Desc;
+	const int32 Root = Desc.AddBone(TEXT("root"), INDEX_NONE, FVector::ZeroVector);
+
+	int32 Parent = Desc.AddBone(TEXT("chain_00"), Root, FVector(0, 0, 100.0f));
+	Desc.SimulationRootBoneName = TEXT("chain_00");
+	for (int32 i = 1; i < NumBones; ++i)
+	{
+		Parent = Desc.AddBone(*FString::Printf(TEXT("chain_%02d"), i), Parent, FVector(BoneLength, 0, 0));
+	}
+	return Desc;
+}
+
+FKawaiiPhysicsTestSkeletonDesc FKawaiiPhysicsTestSkeletonDesc::MakeSkirt(int32 NumStrands, int32 BonesPerStrand,
+                                                                         float RingRadius, float BoneLength)
+{
+	FKawaiiPhysicsTestSkeletonDesc Desc;
+	const int32 Root = Desc.AddBone(TEXT("root"), INDEX_NONE, FVector::ZeroVector);
+	const int32 Pelvis = Desc.AddBone(TEXT("pelvis"), Root, FVector(0, 0, 100.0f));
+	Desc.SimulationRootBoneName = TEXT("pelvis");
+
+	for (int32 Strand = 0; Strand < NumStrands; ++Strand)
+	{
+		const float Angle = 2.0f * PI * Strand / NumStrands;
+		const FVector Outward(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f);
+
+		int32 Parent = Desc.AddBone(*FString::Printf(TEXT("skirt_%02d_00"), Strand), Pelvis, Outward * RingRadius);
+		for (int32 i = 1; i < BonesPerStrand; ++i)
+		{
+			// flare out slightly while going down
+			Parent = Desc.AddBone(*FString::Printf(TEXT("skirt_%02d_%02d"), Strand, i), Parent,
+			                      FVector(0, 0, -BoneLength) + Outward * BoneLength * 0.2f);
+		}
+	}
+	return Desc;
+}
+
+FKawaiiPhysicsTestSkeletonDesc FKawaiiPhysicsTestSkeletonDesc::MakeHair(int32 NumStrands, int32 BonesPerStrand,
+                                                                        float BoneLength)
+{
+	FKawaiiPhysicsTestSkeletonDesc Desc;
+	const int32 Root = Desc.AddBone(TEXT("root"), INDEX_NONE, FVector::ZeroVector);
+	const int32 Head = Desc.AddBone(TEXT("head"), Root, FVector(0, 0, 170.0f));
+	Desc.SimulationRootBoneName = TEXT("head");
+
+	// Distribute strand roots on the upper hemisphere (golden spiral)
+	const float GoldenAngle = PI * (3.0f - FMath::Sqrt(5.0f));
+	for (int32 Strand = 0; Strand < NumStrands; ++Strand)
+	{
+		const float Z = 1.0f - static_cast<float>(Strand) / NumStrands;
+		const float R = FMath::Sqrt(1.0f - Z * Z);
+		const FVector Dir(FMath::Cos(GoldenAngle * Strand) * R, FMath::Sin(GoldenAngle * Strand) * R, Z);
+
+		int32 Parent = Desc.AddBone(*FString::Printf(TEXT("hair_%03d_00"), Strand), Head, Dir * 10.0f);
+		for (int32 i = 1; i < BonesPerStrand; ++i)
+		{
+			Parent = Desc.AddBone(*FString::Printf(TEXT("hair_%03d_%02d"), Strand, i), Parent,
+			                      (Dir * 0.5f + FVector(0, 0, -1.0f)).GetSafeNormal() * BoneLength);
+		}
+	}
+	return Desc;
+}
+
+FKawaiiPhysicsTestSkeletonDesc FKawaiiPhysicsTestSkeletonDesc::MakeBranchingTail(int32 Depth, int32 BranchesPerLevel,
+                                                                                 int32 BonesPerBranch,
+                                                                                 float BoneLength)
+{
+	FKawaiiPhysicsTestSkeletonDesc Desc;
+	const int32 Root = Desc.AddBone(TEXT("root"), INDEX_NONE, FVector::ZeroVector);
+	const int32 TailRoot = Desc.AddBone(TEXT("tail_root"), Root, FVector(-20.0f, 0, 90.0f));
+	Desc.SimulationRootBoneName = TEXT("tail_root");
+
+	TArray<int32> Tips = {TailRoot};
+	for (int32 Level = 0; Level < Depth; ++Level)
+	{
+		TArray<int32> NewTips;
+		for (int32 TipIndex = 0; TipIndex < Tips.Num(); ++TipIndex)
+		{
+			for (int32 Branch = 0; Branch < BranchesPerLevel; ++Branch)
+			{
+				const float Spread = BranchesPerLevel > 1
+					                     ? FMath::Lerp(-0.5f, 0.5f, static_cast<float>(Branch) / (BranchesPerLevel - 1))
+					                     : 0.0f;
+				const FVector Offset = FVector(-1.0f, Spread, -0.2f).GetSafeNormal() * BoneLength;
+
+				int32 Parent = Tips[TipIndex];
+				for (int32 i = 0; i < BonesPerBranch; ++i)
+				{
+					Parent = Desc.AddBone(
+						*FString::Printf(TEXT("tail_%d_%d_%d_%02d"), Level, TipIndex, Branch, i), Parent, Offset);
+				}
+				NewTips.Add(Parent);
+			}
+		}
+		Tips = MoveTemp(NewTips);
+	}
+	return Desc;
+}
+
+FKawaiiPhysicsTestRig::FKawaiiPhysicsTestRig(const FKawaiiPhysicsTestSkeletonDesc& Desc)
+{
+	Skeleton.Reset(NewObject<USkeleton>(GetTransientPackage(), NAME_None, RF_Transient));
+	{
+		// RefSkeleton is rebuilt when the modifier goes out of scope
+		FReferenceSkeletonModifier Modifier(Skeleton.Get());
+		for (const FKawaiiPhysicsTestSkeletonDesc::FBone& Bone : Desc.Bones)
+		{
+			Modifier.Add(FMeshBoneInfo(Bone.Name, Bone.Name.ToString(), Bone.ParentIndex), Bone.LocalTransform);
+		}
+	}
+	NumBones = Desc.Bones.Num();
+
+	TArray<FBoneIndexType> RequiredBoneIndices;
+	RequiredBoneIndices.Reserve(NumBones);
+	for (int32 i = 0; i < NumBones; ++i)
+	{
+		RequiredBoneIndices.Add(static_cast<FBoneIndexType>(i));
+	}
+
+#if	ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 3
+	Proxy.GetRequiredBones().InitializeTo(RequiredBoneIndices, UE::Anim::FCurveFilterSettings(), *Skeleton);
+#else
+	Proxy.GetRequiredBones().InitializeTo(RequiredBoneIndices, FCurveEvaluationOption(false), *Skeleton);
+#endif
+
+	Node.RootBone = FBoneReference(Desc.SimulationRootBoneName);
+}
+
+void FKawaiiPhysicsTestRig::Initialize()
+{
+	// Same order as an AnimInstance : Initialize -> CacheBones -> (Update) -> Evaluate
+	Node.Initialize_AnyThread(FAnimationInitializeContext(&Proxy));
+	Node.CacheBones_AnyThread(FAnimationCacheBonesContext(&Proxy));
+}
+
+double FKawaiiPhysicsTestRig::Evaluate(float DeltaTime, const FTransform& RootTransform)
+{
+	FCompactPose LocalPose;
+	LocalPose.SetBoneContainer(&Proxy.GetRequiredBones());
+	LocalPose.ResetToRefPose();
+	LocalPose[FCompactPoseBoneIndex(0)] = RootTransform;
+
+	FComponentSpacePoseContext Output(&Proxy);
+	Output.Pose.InitPose(LocalPose);
+
+	// Normally set in UpdateInternal
+	Node.DeltaTime = DeltaTime;
+
+	// Normally run on the game thread in PreUpdate. No component here
+	Node.PreApplyExternalForces(nullptr);
+
+	OutBoneTransforms.Reset();
+	const double StartTime = FPlatformTime::Seconds();
+	Node.EvaluateSkeletalControl_AnyThread(Output, OutBoneTransforms);
+	return FPlatformTime::Seconds() - StartTime;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimNode_KawaiiPhysics.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "UObject/StrongObjectPtr.h"
+
+class USkeleton;
+
+/**
+ * 合成スケルトンの定義
+ * Description of a synthetic reference skeleton. Bone 0 is always the "root" bone which receives the scripted motion
+ */
+struct FKawaiiPhysicsTestSkeletonDesc
+{
+	struct FBone
+	{
+		FName Name;
+		int32 ParentIndex = INDEX_NONE;
+		FTransform LocalTransform;
+	};
+
+	TArray<FBone> Bones;
+
+	/** Bone used as RootBone of the KawaiiPhysics node */
+	FName SimulationRootBoneName;
+
+	int32 AddBone(const FName& Name, int32 ParentIndex, const FVector& LocalOffset);
+
+	/** Single chain hanging from the root */
+	static FKawaiiPhysicsTestSkeletonDesc MakeSingleChain(int32 NumBones, float BoneLength);
+	/** Ring of strands around a pelvis bone */
+	static FKawaiiPhysicsTestSkeletonDesc MakeSkirt(int32 NumStrands, int32 BonesPerStrand, float RingRadius,
+	                                                float BoneLength);
+	/** Many short strands on a head bone */
+	static FKawaiiPhysicsTestSkeletonDesc MakeHair(int32 NumStrands, int32 BonesPerStrand, float BoneLength);
+	/** Tail that splits into several branches at each level */
+	static FKawaiiPhysicsTestSkeletonDesc MakeBranchingTail(int32 Depth, int32 BranchesPerLevel,
+	                                                        int32 BonesPerBranch, float BoneLength);
+};
+
+/**
+ * AnimInstanceなしでFAnimNode_KawaiiPhysicsを駆動するためのリグ
+ * Drives FAnimNode_KawaiiPhysics through Initialize/CacheBones/Evaluate without an AnimInstance or a world,
+ * so it can run headless (-nullrhi)
+ */
+class FKawaiiPhysicsTestRig
+{
+public:
+	explicit FKawaiiPhysicsTestRig(const FKawaiiPhysicsTestSkeletonDesc& Desc);
+
+	FKawaiiPhysicsTestRig(const FKawaiiPhysicsTestRig&) = delete;
+	FKawaiiPhysicsTestRig& operator=(const FKawaiiPhysicsTestRig&) = delete;
+
+	/** Configure Node before calling Initialize */
+	FAnimNode_KawaiiPhysics Node;
+
+	void Initialize();
+
+	/**
+	 * Evaluate one frame with the given root bone transform
+	 * @return seconds spent in EvaluateSkeletalControl_AnyThread
+	 */
+	double Evaluate(float DeltaTime, const FTransform& RootTransform);
+
+	const TArray<FBoneTransform>& GetOutBoneTransforms() const { return OutBoneTransforms; }
+	int32 GetNumBones() const { return NumBones; }
+
+private:
+	TStrongObjectPtr<USkeleton> Skeleton;
+	FAnimInstanceProxy Proxy;
+	TArray<FBoneTransform> OutBoneTransforms;
+	int32 NumBones = 0;
+};
@@ -0,0 +1,716 @@
+#include "KawaiiPhysicsTestRig.h"
+
+#include "KawaiiPhysicsExternalForce.h"
+#include "KawaiiPhysicsSimulationCache.h"
+#include "Dom/JsonObject.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace KawaiiPhysicsTests
+{
+	constexpr float TestDeltaTime = 1.0f / 60.0f;
+	constexpr int32 CorrectnessFrames = 300;
+	constexpr int32 PerfWarmUpFrames = 30;
+	constexpr int32 PerfMeasureFrames = 240;
+
+	// Bone length is restored at the end of each step, so this only absorbs float error
+	constexpr float BoneLengthTolerance = 0.01f;
+
+	const TCHAR* const TestCaseNames[] = {TEXT("SingleChain"), TEXT("Skirt"), TEXT("Hair"), TEXT("BranchingTail")};
+
+	FKawaiiPhysicsTestSkeletonDesc MakeTestSkeleton(const FString& TestCase)
+	{
+		if (TestCase == TEXT("Skirt"))
+		{
+			return FKawaiiPhysicsTestSkeletonDesc::MakeSkirt(16, 20, 15.0f, 4.0f);
+		}
+		if (TestCase == TEXT("Hair"))
+		{
+			return FKawaiiPhysicsTestSkeletonDesc::MakeHair(500, 8, 3.0f);
+		}
+		if (TestCase == TEXT("BranchingTail"))
+		{
+			return FKawaiiPhysicsTestSkeletonDesc::MakeBranchingTail(3, 3, 4, 5.0f);
+		}
+		return FKawaiiPhysicsTestSkeletonDesc::MakeSingleChain(16, 10.0f);
+	}
+
+	void SetupNode(FAnimNode_KawaiiPhysics& Node, const FString& TestCase)
+	{
+		Node.Gravity = FVector(0, 0, -980.0f);
+		Node.PhysicsSettings.Damping = 0.1f;
+		Node.PhysicsSettings.Stiffness = 0.02f;
+		Node.PhysicsSettings.Radius = 2.0f;
+
+		// A sphere below the simulation root that the bones fall onto
+		FSphericalLimit Sphere;
+		Sphere.DrivingBone = FBoneReference(TEXT("root"));
+		Sphere.Radius = 20.0f;
+		Sphere.LimitType = ESphericalLimitType::Outer;
+		if (TestCase == TEXT("SingleChain"))
+		{
+			Sphere.OffsetLocation = FVector(80.0f, 0, 60.0f);
+		}
+		else if (TestCase == TEXT("Skirt"))
+		{
+			Sphere.OffsetLocation = FVector(0, 0, 60.0f);
+		}
+		else if (TestCase == TEXT("Hair"))
+		{
+			Sphere.OffsetLocation = FVector(0, 0, 150.0f);
+		}
+		else
+		{
+			Sphere.OffsetLocation = FVector(-45.0f, 0, 75.0f);
+		}
+		Node.SphericalLimits.Add(Sphere);
+	}
+
+	/** Scripted root motion : sway and turn */
+	FTransform GetRootTransform(int32 Frame)
+	{
+		const float Time = Frame * TestDeltaTime;
+		return FTransform(FRotator(0, 45.0f * FMath::Sin(Time * 2.0f), 0),
+		                  FVector(50.0f * FMath::Sin(Time * 3.0f), 30.0f * FMath::Cos(Time * 2.0f), 0));
+	}
+
+	bool CheckInvariants(FAutomationTestBase& Test, const FAnimNode_KawaiiPhysics& Node, int32 Frame)
+	{
+		bool bResult = true;
+		for (const FKawaiiPhysicsModifyBone& Bone : Node.ModifyBones)
+		{
+			if (Bone.Location.ContainsNaN() || Node.GetPoseLocation(Bone.Index).ContainsNaN())
+			{
+				Test.AddError(FString::Printf(TEXT("Frame %d : NaN on bone %s"), Frame,
+				                              *Node.GetModifyBoneName(Bone.Index).ToString()));
+				return false;
+			}
+
+			if (Bone.ParentIndex < 0)
+			{
+				continue;
+			}
+			const FKawaiiPhysicsModifyBone& ParentBone = Node.ModifyBones[Bone.ParentIndex];
+
+			const float PoseLength = (Node.GetPoseLocation(Bone.Index) - Node.GetPoseLocation(ParentBone.Index)).Size();
+			const float SimLength = (Bone.Location - ParentBone.Location).Size();
+			if (!FMath::IsNearlyEqual(PoseLength, SimLength, BoneLengthTolerance))
+			{
+				Test.AddError(FString::Printf(TEXT("Frame %d : bone length of %s changed %f -> %f"), Frame,
+				                              *Node.GetModifyBoneName(Bone.Index).ToString(), PoseLength, SimLength));
+				bResult = false;
+			}
+
+			// Length restore runs after collision, so a bone may sink in by up to its own radius
+			for (const FSphericalLimit& Sphere : Node.SphericalLimits)
+			{
+				if (!Sphere.bEnable || Sphere.LimitType != ESphericalLimitType::Outer)
+				{
+					continue;
+				}
+				const float Distance = (Bone.Location - Sphere.Location).Size();
+				if (Distance < Sphere.Radius - KINDA_SMALL_NUMBER)
+				{
+					Test.AddError(FString::Printf(TEXT("Frame %d : bone %s penetrates sphere (%f < %f)"), Frame,
+					                              *Node.GetModifyBoneName(Bone.Index).ToString(), Distance,
+					                              Sphere.Radius));
+					bResult = false;
+				}
+			}
+		}
+		return bResult;
+	}
+
+	FString GetBaselinePath()
+	{
+		FString Path;
+		if (!FParse::Value(FCommandLine::Get(), TEXT("KawaiiPhysicsPerfBaseline="), Path))
+		{
+			Path = FPaths::ProjectSavedDir() / TEXT("Automation/KawaiiPhysics/PerfBaseline.json");
+		}
+		return Path;
+	}
+
+	TSharedPtr<FJsonObject> LoadBaseline(const FString& Path)
+	{
+		FString JsonString;
+		TSharedPtr<FJsonObject> Root;
+		if (FFileHelper::LoadFileToString(JsonString, *Path))
+		{
+			FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonString), Root);
+		}
+		return Root;
+	}
+
+	void SaveBaseline(const FString& Path, const TSharedRef<FJsonObject>& Root)
+	{
+		FString JsonString;
+		FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&JsonString));
+		FFileHelper::SaveStringToFile(JsonString, *Path);
+	}
+}
+
+/**
+ * 合成スケルトンでの正当性テスト（NaN、ボーン長、コリジョン）
+ * Correctness invariants on synthetic skeletons : no NaN, bone length preserved, sphere collision respected
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FKawaiiPhysicsCorrectnessTest, "Plugins.KawaiiPhysics.Correctness",
+                                  EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+void FKawaiiPhysicsCorrectnessTest::GetTests(TArray<FString>& OutBeautifiedNames,
+                                             TArray<FString>& OutTestCommands) const
+{
+	for (const TCHAR* TestCase : KawaiiPhysicsTests::TestCaseNames)
+	{
+		OutBeautifiedNames.Add(TestCase);
+		OutTestCommands.Add(TestCase);
+	}
+}
+
+bool FKawaiiPhysicsCorrectnessTest::RunTest(const FString& Parameters)
+{
+	using namespace KawaiiPhysicsTests;
+
+	FKawaiiPhysicsTestRig Rig(MakeTestSkeleton(Parameters));
+	SetupNode(Rig.Node, Parameters);
+	Rig.Initialize();
+
+	for (int32 Frame = 0; Frame < CorrectnessFrames; ++Frame)
+	{
+		Rig.Evaluate(TestDeltaTime, GetRootTransform(Frame));
+		if (!CheckInvariants(*this, Rig.Node, Frame))
+		{
+			break;
+		}
+	}
+
+	TestTrue(TEXT("Simulated bones"), Rig.Node.ModifyBones.Num() > 1);
+	TestEqual(TEXT("Output bone count"), Rig.GetOutBoneTransforms().Num(), Rig.Node.ModifyBones.Num());
+
+	return !HasAnyErrors();
+}
+
+/**
+ * 細いコリジョンがボーンの線分をすり抜けないことのテスト
+ * A thin sphere between two bones of the single chain must not end up inside any bone segment
+ * with bUseSegmentCollision on
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKawaiiPhysicsSegmentCollisionTest, "Plugins.KawaiiPhysics.SegmentCollision",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKawaiiPhysicsSegmentCollisionTest::RunTest(const FString& Parameters)
+{
+	using namespace KawaiiPhysicsTests;
+
+	FKawaiiPhysicsTestRig Rig(MakeTestSkeleton(TEXT("SingleChain")));
+	SetupNode(Rig.Node, TEXT("SingleChain"));
+	Rig.Node.bUseSegmentCollision = true;
+
+	// Below the middle of the 4th segment : its ends are farther than Radius + bone Radius from the center,
+	// so the chain would fall through it with end point collision only
+	FSphericalLimit ThinSphere;
+	ThinSphere.DrivingBone = FBoneReference(TEXT("root"));
+	ThinSphere.Radius = 1.0f;
+	ThinSphere.OffsetLocation = FVector(35.0f, 0, 92.0f);
+	ThinSphere.LimitType = ESphericalLimitType::Outer;
+	Rig.Node.SphericalLimits.Add(ThinSphere);
+	Rig.Initialize();
+
+	for (int32 Frame = 0; Frame < CorrectnessFrames; ++Frame)
+	{
+		Rig.Evaluate(TestDeltaTime, GetRootTransform(Frame));
+		if (!CheckInvariants(*this, Rig.Node, Frame))
+		{
+			break;
+		}
+
+		// Length restore runs after collision, so a segment may sink in by up to the bone radius, not past the center
+		const FSphericalLimit& Sphere = Rig.Node.SphericalLimits.Last();
+		bool bPenetrated = false;
+		for (const FKawaiiPhysicsModifyBone& Bone : Rig.Node.ModifyBones)
+		{
+			if (Bone.ParentIndex < 0)
+			{
+				continue;
+			}
+			const FKawaiiPhysicsModifyBone& ParentBone = Rig.Node.ModifyBones[Bone.ParentIndex];
+			const float Distance = FMath::PointDistToSegment(FVector(Sphere.Location), FVector(ParentBone.Location),
+			                                                 FVector(Bone.Location));
+			if (Distance < Sphere.Radius - KINDA_SMALL_NUMBER)
+			{
+				AddError(FString::Printf(TEXT("Frame %d : segment to %s passes through the thin sphere (%f < %f)"),
+				                         Frame, *Rig.Node.GetModifyBoneName(Bone.Index).ToString(), Distance,
+				                         Sphere.Radius));
+				bPenetrated = true;
+			}
+		}
+		if (bPenetrated)
+		{
+			break;
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+/**
+ * 異なるチェーンのボーン同士が重ならないことのテスト
+ * Bones of different skirt strands must not overlap with bEnableSelfCollision on
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKawaiiPhysicsSelfCollisionTest, "Plugins.KawaiiPhysics.SelfCollision",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKawaiiPhysicsSelfCollisionTest::RunTest(const FString& Parameters)
+{
+	using namespace KawaiiPhysicsTests;
+
+	FKawaiiPhysicsTestRig Rig(MakeTestSkeleton(TEXT("Skirt")));
+	SetupNode(Rig.Node, TEXT("Skirt"));
+	Rig.Node.bEnableSelfCollision = true;
+	Rig.Initialize();
+
+	const TArray<FKawaiiPhysicsModifyBone>& Bones = Rig.Node.ModifyBones;
+	TArray<int32> Chains;
+	for (int32 Frame = 0; Frame < CorrectnessFrames; ++Frame)
+	{
+		Rig.Evaluate(TestDeltaTime, GetRootTransform(Frame));
+		if (!CheckInvariants(*this, Rig.Node, Frame))
+		{
+			break;
+		}
+
+		// Same chains as the node once the bones are built : each child of the root bone starts one
+		if (Chains.Num() != Bones.Num())
+		{
+			Chains.Init(INDEX_NONE, Bones.Num());
+			for (int32 i = 1; i < Bones.Num(); ++i)
+			{
+				Chains[i] = Bones[i].ParentIndex == 0 ? i : Chains[Bones[i].ParentIndex];
+			}
+		}
+
+		// Length restore runs after collision and may pull a pair back in a little, never by a whole radius
+		bool bOverlapped = false;
+		for (int32 i = 0; i < Bones.Num() && !bOverlapped; ++i)
+		{
+			for (int32 j = i + 1; j < Bones.Num(); ++j)
+			{
+				if (Chains[i] == INDEX_NONE || Chains[j] == INDEX_NONE || Chains[i] == Chains[j] ||
+					Bones[i].ParentIndex == Bones[j].ParentIndex)
+				{
+					continue;
+				}
+				const float MinDistance = (Bones[i].PhysicsSettings.Radius + Bones[j].PhysicsSettings.Radius) * 0.75f;
+				const float Distance = (Bones[i].Location - Bones[j].Location).Size();
+				if (Distance < MinDistance - KINDA_SMALL_NUMBER)
+				{
+					AddError(FString::Printf(TEXT("Frame %d : %s and %s of different chains overlap (%f < %f)"), Frame,
+					                         *Rig.Node.GetModifyBoneName(i).ToString(),
+					                         *Rig.Node.GetModifyBoneName(j).ToString(), Distance, MinDistance));
+					bOverlapped = true;
+					break;
+				}
+			}
+		}
+		if (bOverlapped)
+		{
+			break;
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+/**
+ * シミュレーションキャッシュの記録・巻き戻し・再記録・再生のテスト
+ * Record, scrub back, record again and play back : the frames between the restored keyframe and the scrub
+ * target are simulated again, so the playback matches the first take
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKawaiiPhysicsSimulationCacheTest, "Plugins.KawaiiPhysics.SimulationCache",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKawaiiPhysicsSimulationCacheTest::RunTest(const FString& Parameters)
+{
+	using namespace KawaiiPhysicsTests;
+
+	constexpr int32 NumFrames = 90;
+	constexpr int32 KeyframeInterval = 30;
+	constexpr int32 ScrubFrame = 45;
+	// Re-simulated steps only differ by float error, playback adds the 16 bit quantization
+	constexpr float RecordTolerance = 0.01f;
+	constexpr float PlaybackTolerance = 0.1f;
+
+	TStrongObjectPtr<UKawaiiPhysicsSimulationCache> Cache(NewObject<UKawaiiPhysicsSimulationCache>());
+	Cache->FrameRate = 1.0f / TestDeltaTime;
+	Cache->KeyframeInterval = KeyframeInterval;
+
+	FKawaiiPhysicsTestRig Rig(MakeTestSkeleton(TEXT("SingleChain")));
+	SetupNode(Rig.Node, TEXT("SingleChain"));
+	Rig.Node.SimulationCacheMode = EKawaiiPhysicsSimulationCacheMode::Record;
+	Rig.Node.SimulationCache = Cache.Get();
+	Rig.Node.bAdvanceSimulationCacheTime = false;
+	Rig.Initialize();
+
+	// Static root : the same steps from the same keyframe give the same frames
+	auto EvaluateFrame = [&Rig](int32 Frame)
+	{
+		Rig.Node.SimulationCacheTime = Frame * TestDeltaTime;
+		Rig.Evaluate(TestDeltaTime, FTransform::Identity);
+	};
+	auto CompareFrame = [this, &Rig](const TArray<FVector3f>& Expected, int32 Frame, float Tolerance)
+	{
+		for (int32 i = 0; i < Expected.Num(); ++i)
+		{
+			const float Distance = (Rig.Node.ModifyBones[i].Location - Expected[i]).Size();
+			if (Distance > Tolerance)
+			{
+				AddError(FString::Printf(TEXT("Frame %d : bone %s is %f away from the first take"), Frame,
+				                         *Rig.Node.GetModifyBoneName(i).ToString(), Distance));
+				return false;
+			}
+		}
+		return true;
+	};
+
+	TArray<TArray<FVector3f>> FirstTake;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		EvaluateFrame(Frame);
+		TArray<FVector3f>& Locations = FirstTake.AddDefaulted_GetRef();
+		for (const FKawaiiPhysicsModifyBone& Bone : Rig.Node.ModifyBones)
+		{
+			Locations.Add(Bone.Location);
+		}
+	}
+
+	// The chain must still move between the keyframe and the scrub target, or frozen frames would go unnoticed
+	float MaxMotion = 0.0f;
+	for (int32 i = 0; i < FirstTake[ScrubFrame].Num(); ++i)
+	{
+		MaxMotion = FMath::Max(MaxMotion, (FirstTake[ScrubFrame][i] - FirstTake[KeyframeInterval + 1][i]).Size());
+	}
+	TestTrue(TEXT("Chain moves after the keyframe"), MaxMotion > PlaybackTolerance * 10.0f);
+
+	for (int32 Frame = ScrubFrame; Frame < NumFrames; ++Frame)
+	{
+		EvaluateFrame(Frame);
+		if (!CompareFrame(FirstTake[Frame], Frame, RecordTolerance))
+		{
+			break;
+		}
+	}
+	Cache->FinishRecording();
+	TestEqual(TEXT("Recorded frames"), Cache->NumFrames, NumFrames);
+
+	Rig.Node.SimulationCacheMode = EKawaiiPhysicsSimulationCacheMode::Playback;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		EvaluateFrame(Frame);
+		if (!CompareFrame(FirstTake[Frame], Frame, PlaybackTolerance))
+		{
+			break;
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+/**
+ * キャッシュのフレームレートより速い評価と一時停止中の記録テスト
+ * Record while evaluating at twice the cache frame rate and pausing on a frame : the simulation steps once per
+ * cache frame, holds while the frame does not advance, and records the same take as an evaluation per frame
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKawaiiPhysicsSimulationCacheHoldTest, "Plugins.KawaiiPhysics.SimulationCacheHold",
+                                 EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKawaiiPhysicsSimulationCacheHoldTest::RunTest(const FString& Parameters)
+{
+	using namespace KawaiiPhysicsTests;
+
+	constexpr int32 NumFrames = 60;
+	constexpr int32 PauseFrame = 20;
+	constexpr int32 PauseEvaluations = 30;
+	constexpr float CacheFrameRate = 0.5f / TestDeltaTime;
+	constexpr float RecordTolerance = 0.01f;
+	constexpr float PlaybackTolerance = 0.1f;
+
+	auto MakeRig = [](UKawaiiPhysicsSimulationCache* Cache)
+	{
+		Cache->FrameRate = CacheFrameRate;
+		TUniquePtr<FKawaiiPhysicsTestRig> Rig =
+			MakeUnique<FKawaiiPhysicsTestRig>(MakeTestSkeleton(TEXT("SingleChain")));
+		SetupNode(Rig->Node, TEXT("SingleChain"));
+		Rig->Node.SimulationCacheMode = EKawaiiPhysicsSimulationCacheMode::Record;
+		Rig->Node.SimulationCache = Cache;
+		Rig->Node.bAdvanceSimulationCacheTime = false;
+		Rig->Initialize();
+		return Rig;
+	};
+	auto GetLocations = [](const FKawaiiPhysicsTestRig& Rig)
+	{
+		TArray<FVector3f> Locations;
+		for (const FKawaiiPhysicsModifyBone& Bone : Rig.Node.ModifyBones)
+		{
+			Locations.Add(Bone.Location);
+		}
+		return Locations;
+	};
+	auto CompareLocations = [this](const TArray<FVector3f>& Actual, const TArray<FVector3f>& Expected,
+	                               const TCHAR* What, int32 Frame, float Tolerance)
+	{
+		for (int32 i = 0; i < Expected.Num(); ++i)
+		{
+			const float Distance = (Actual[i] - Expected[i]).Size();
+			if (Distance > Tolerance)
+			{
+				AddError(FString::Printf(TEXT("%s, frame %d : bone %d is %f away from the reference"), What, Frame, i,
+				                         Distance));
+				return false;
+			}
+		}
+		return true;
+	};
+
+	// Reference : one evaluation per cache frame
+	TStrongObjectPtr<UKawaiiPhysicsSimulationCache> ReferenceCache(NewObject<UKawaiiPhysicsSimulationCache>());
+	TUniquePtr<FKawaiiPhysicsTestRig> ReferenceRig = MakeRig(ReferenceCache.Get());
+	TArray<TArray<FVector3f>> ReferenceTake;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		ReferenceRig->Node.SimulationCacheTime = Frame / CacheFrameRate;
+		ReferenceRig->Evaluate(1.0f / CacheFrameRate, FTransform::Identity);
+		ReferenceTake.Add(GetLocations(*ReferenceRig));
+	}
+
+	// Two evaluations per cache frame, and a pause on PauseFrame
+	TStrongObjectPtr<UKawaiiPhysicsSimulationCache> Cache(NewObject<UKawaiiPhysicsSimulationCache>());
+	TUniquePtr<FKawaiiPhysicsTestRig> Rig = MakeRig(Cache.Get());
+	int32 LastFrame = INDEX_NONE;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		const int32 NumEvaluations = Frame == PauseFrame ? PauseEvaluations : 2;
+		for (int32 Evaluation = 0; Evaluation < NumEvaluations; ++Evaluation)
+		{
+			Rig->Node.SimulationCacheTime = Frame / CacheFrameRate;
+			Rig->Evaluate(TestDeltaTime, FTransform::Identity);
+			if (!CompareLocations(GetLocations(*Rig), ReferenceTake[Frame], TEXT("Record"), Frame, RecordTolerance))
+			{
+				break;
+			}
+		}
+		LastFrame = Frame;
+		if (HasAnyErrors())
+		{
+			break;
+		}
+	}
+	TestEqual(TEXT("Evaluated frames"), LastFrame, NumFrames - 1);
+
+	Cache->FinishRecording();
+	TestEqual(TEXT("Recorded frames"), Cache->NumFrames, NumFrames);
+
+	// The held frame and its neighbours must not have been overwritten by the pause
+	Rig->Node.SimulationCacheMode = EKawaiiPhysicsSimulationCacheMode::Playback;
+	for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+	{
+		Rig->Node.SimulationCacheTime = Frame / CacheFrameRate;
+		Rig->Evaluate(TestDeltaTime, FTransform::Identity);
+		if (!CompareLocations(GetLocations(*Rig), ReferenceTake[Frame], TEXT("Playback"), Frame, PlaybackTolerance))
+		{
+			break;
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+/**
+ * SaveState/RestoreStateのテスト（保存→状態を変更→復元）
+ * Save, move on and restore, with the full and the quantized state. A truncated state must fail
+ * and leave the node untouched
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FKawaiiPhysicsSaveStateTest, "Plugins.KawaiiPhysics.SaveState",
+                                  EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+void FKawaiiPhysicsSaveStateTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	OutBeautifiedNames.Add(TEXT("Full"));
+	OutTestCommands.Add(TEXT("Full"));
+	OutBeautifiedNames.Add(TEXT("Quantized"));
+	OutTestCommands.Add(TEXT("Quantized"));
+}
+
+bool FKawaiiPhysicsSaveStateTest::RunTest(const FString& Parameters)
+{
+	using namespace KawaiiPhysicsTests;
+
+	constexpr int32 SaveFrame = 60;
+	constexpr int32 PerturbFrames = 30;
+	const bool bQuantize = Parameters == TEXT("Quantized");
+	// Quantized locations are within 1/65535 of the chain bounds
+	const float Tolerance = bQuantize ? 0.01f : 0.0f;
+
+	FKawaiiPhysicsTestRig Rig(MakeTestSkeleton(TEXT("SingleChain")));
+	SetupNode(Rig.Node, TEXT("SingleChain"));
+
+	// An interval force so that the force timer is part of the state
+	FKawaiiPhysics_ExternalForce_Basic Force;
+	Force.ForceDir = FVector(0, 500.0f, 0);
+	Force.Interval = 0.5f;
+	Rig.Node.ExternalForces.Add(FInstancedStruct::Make(Force));
+	Rig.Initialize();
+
+	auto GetLocations = [&Rig]()
+	{
+		TArray<FVector3f> Locations;
+		for (const FKawaiiPhysicsModifyBone& Bone : Rig.Node.ModifyBones)
+		{
+			Locations.Add(Bone.Location);
+			Locations.Add(Bone.PrevLocation);
+		}
+		return Locations;
+	};
+	auto CompareLocations = [this](const TCHAR* What, const TArray<FVector3f>& Actual,
+	                               const TArray<FVector3f>& Expected, float InTolerance)
+	{
+		for (int32 i = 0; i < Expected.Num(); ++i)
+		{
+			const float Distance = (Actual[i] - Expected[i]).Size();
+			if (Distance > InTolerance)
+			{
+				AddError(FString::Printf(TEXT("%s : location %d is %f away"), What, i, Distance));
+				return;
+			}
+		}
+	};
+
+	int32 Frame = 0;
+	for (; Frame < SaveFrame; ++Frame)
+	{
+		Rig.Evaluate(TestDeltaTime, GetRootTransform(Frame));
+	}
+
+	TArray<uint8> State;
+	Rig.Node.SaveState(State, bQuantize);
+	const TArray<FVector3f> Saved = GetLocations();
+
+	TArray<TArray<FVector3f>> FirstRun;
+	for (int32 i = 0; i < PerturbFrames; ++i)
+	{
+		Rig.Evaluate(TestDeltaTime, GetRootTransform(Frame + i));
+		FirstRun.Add(GetLocations());
+	}
+
+	// Truncated : fails without touching the node
+	TArray<uint8> Truncated = State;
+	Truncated.SetNum(State.Num() - 1);
+	const TArray<FVector3f> BeforeFailedRestore = GetLocations();
+	TestFalse(TEXT("Truncated state is rejected"), Rig.Node.RestoreState(Truncated));
+	CompareLocations(TEXT("After the truncated restore"), GetLocations(), BeforeFailedRestore, 0.0f);
+
+	TestTrue(TEXT("State is restored"), Rig.Node.RestoreState(State));
+	CompareLocations(TEXT("Restored"), GetLocations(), Saved, Tolerance);
+
+	// The full state replays the same frames, force timers and random stream included
+	if (!bQuantize)
+	{
+		for (int32 i = 0; i < PerturbFrames; ++i)
+		{
+			Rig.Evaluate(TestDeltaTime, GetRootTransform(Frame + i));
+			CompareLocations(*FString::Printf(TEXT("Replayed frame %d"), Frame + i), GetLocations(), FirstRun[i],
+			                 KINDA_SMALL_NUMBER);
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+/**
+ * 合成スケルトンでの処理時間計測。保存済みのベースラインから一定以上遅くなったら失敗
+ * Time per frame / per bone on synthetic skeletons. Fails when slower than the stored baseline beyond the tolerance
+ *  -KawaiiPhysicsPerfBaseline=<path>   baseline json (default : Saved/Automation/KawaiiPhysics/PerfBaseline.json)
+ *  -KawaiiPhysicsPerfTolerance=<rate>  allowed slowdown rate (default : 0.25)
+ *  -KawaiiPhysicsPerfUpdateBaseline    overwrite the baseline with this run
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FKawaiiPhysicsPerfTest, "Plugins.KawaiiPhysics.Perf",
+                                  EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FKawaiiPhysicsPerfTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (const TCHAR* TestCase : KawaiiPhysicsTests::TestCaseNames)
+	{
+		OutBeautifiedNames.Add(TestCase);
+		OutTestCommands.Add(TestCase);
+	}
+}
+
+bool FKawaiiPhysicsPerfTest::RunTest(const FString& Parameters)
+{
+	using namespace KawaiiPhysicsTests;
+
+	FKawaiiPhysicsTestRig Rig(MakeTestSkeleton(Parameters));
+	SetupNode(Rig.Node, Parameters);
+	Rig.Initialize();
+
+	int32 Frame = 0;
+	for (; Frame < PerfWarmUpFrames; ++Frame)
+	{
+		Rig.Evaluate(TestDeltaTime, GetRootTransform(Frame));
+	}
+
+	double TotalSeconds = 0.0;
+	for (int32 i = 0; i < PerfMeasureFrames; ++i, ++Frame)
+	{
+		TotalSeconds += Rig.Evaluate(TestDeltaTime, GetRootTransform(Frame));
+	}
+
+	const int32 NumBones = FMath::Max(Rig.Node.ModifyBones.Num(), 1);
+	const double UsPerFrame = TotalSeconds * 1e6 / PerfMeasureFrames;
+	const double NsPerBone = UsPerFrame * 1e3 / NumBones;
+	AddInfo(FString::Printf(TEXT("%s : %d bones, %.2f us/frame, %.2f ns/bone"), *Parameters, NumBones, UsPerFrame,
+	                        NsPerBone));
+
+	float Tolerance = 0.25f;
+	FParse::Value(FCommandLine::Get(), TEXT("KawaiiPhysicsPerfTolerance="), Tolerance);
+	const bool bUpdateBaseline = FParse::Param(FCommandLine::Get(), TEXT("KawaiiPhysicsPerfUpdateBaseline"));
+
+	const FString BaselinePath = GetBaselinePath();
+	TSharedPtr<FJsonObject> Baseline = LoadBaseline(BaselinePath);
+	if (!Baseline.IsValid())
+	{
+		Baseline = MakeShared<FJsonObject>();
+	}
+
+	const TSharedPtr<FJsonObject>* Entry = nullptr;
+	if (!bUpdateBaseline && Baseline->TryGetObjectField(Parameters, Entry))
+	{
+		const double BaselineNsPerBone = (*Entry)->GetNumberField(TEXT("NsPerBone"));
+		if (BaselineNsPerBone > 0.0 && NsPerBone > BaselineNsPerBone * (1.0 + Tolerance))
+		{
+			AddError(FString::Printf(TEXT("%s : %.2f ns/bone regressed from baseline %.2f ns/bone (tolerance %.0f%%)"),
+			                         *Parameters, NsPerBone, BaselineNsPerBone, Tolerance * 100.0f));
+		}
+		return !HasAnyErrors();
+	}
+
+	// No baseline yet (or update requested) : record this run
+	const TSharedRef<FJsonObject> NewEntry = MakeShared<FJsonObject>();
+	NewEntry->SetNumberField(TEXT("NumBones"), NumBones);
+	NewEntry->SetNumberField(TEXT("UsPerFrame"), UsPerFrame);
+	NewEntry->SetNumberField(TEXT("NsPerBone"), NsPerBone);
+	Baseline->SetObjectField(Parameters, NewEntry);
+	SaveBaseline(BaselinePath, Baseline.ToSharedRef());
+	AddInfo(FString::Printf(TEXT("Recorded baseline to %s"), *BaselinePath));
+
+	return true;
+}
+
+#endif